@@ -0,0 +1,315 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <plaincraft_core.hpp>
+#include <lib/PerlinNoise.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace plaincraft_core;
+
+// Meshes fixed chunk corpora with every mesher variant and writes the measurements as JSON.
+// Usage: MeshingBenchmark [--iterations count] [--output path]
+
+namespace
+{
+	std::atomic<uint64_t> allocations_count{0};
+}
+
+void *operator new(std::size_t size)
+{
+	allocations_count.fetch_add(1, std::memory_order_relaxed);
+	if (auto memory = std::malloc(size == 0 ? 1 : size))
+	{
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+namespace
+{
+	constexpr int32_t corpus_size = 4;
+	constexpr uint64_t corpus_seed = 1337;
+	constexpr uint32_t default_iterations_count = 20;
+	constexpr uint64_t chunk_volume = Chunk::chunk_size * Chunk::chunk_size * Chunk::chunk_height;
+
+	// Chunks of a corpus_size x corpus_size grid, chunks[z * corpus_size + x]
+	struct Corpus
+	{
+		const char *name;
+		std::vector<std::shared_ptr<Chunk>> chunks;
+	};
+
+	struct MeshingVariant
+	{
+		const char *name;
+		MeshingMode meshing_mode;
+		uint32_t lod_level;
+	};
+
+	struct BenchmarkResult
+	{
+		const char *corpus_name;
+		const char *variant_name;
+		uint64_t chunks_count;
+		double seconds;
+		uint64_t quads_count;
+		uint64_t allocations_count;
+	};
+
+	using BlockGenerator = std::function<BlockId(int32_t x, uint32_t y, int32_t z)>;
+	using ChunkGenerator = std::function<void(const std::shared_ptr<Chunk> &chunk)>;
+
+	Corpus CreateCorpus(const char *name, const ChunkGenerator &generator)
+	{
+		Corpus corpus{name, {}};
+		for (int32_t chunk_z = 0; chunk_z < corpus_size; ++chunk_z)
+		{
+			for (int32_t chunk_x = 0; chunk_x < corpus_size; ++chunk_x)
+			{
+				auto chunk = std::make_shared<Chunk>(chunk_x, chunk_z);
+				generator(chunk);
+				chunk->initialized_ = true;
+				corpus.chunks.push_back(chunk);
+			}
+		}
+		return corpus;
+	}
+
+	ChunkGenerator FillBlocks(const BlockGenerator &generator)
+	{
+		return [generator](const std::shared_ptr<Chunk> &chunk)
+		{
+			auto origin_x = chunk->GetPositionX() * static_cast<int32_t>(Chunk::chunk_size);
+			auto origin_z = chunk->GetPositionZ() * static_cast<int32_t>(Chunk::chunk_size);
+			for (uint32_t y = 0; y < Chunk::chunk_height; ++y)
+			{
+				for (uint32_t z = 0; z < Chunk::chunk_size; ++z)
+				{
+					for (uint32_t x = 0; x < Chunk::chunk_size; ++x)
+					{
+						auto block_id = generator(origin_x + static_cast<int32_t>(x), y, origin_z + static_cast<int32_t>(z));
+						if (block_id != BlockIds::air)
+						{
+							chunk->SetBlock(x, y, z, block_id);
+						}
+					}
+				}
+			}
+		};
+	}
+
+	std::vector<Corpus> CreateCorpora()
+	{
+		std::vector<Corpus> corpora;
+
+		corpora.push_back(CreateCorpus("flat", FillBlocks([](int32_t, uint32_t y, int32_t)
+														  { return y < 31 ? BlockIds::stone : y == 31 ? BlockIds::dirt : BlockIds::air; })));
+
+		ChunkBuilder chunk_builder(nullptr, corpus_seed);
+		corpora.push_back(CreateCorpus("perlin", [&chunk_builder](const std::shared_ptr<Chunk> &chunk)
+									   { chunk_builder.GenerateChunk(chunk, CancellationToken()); }));
+
+		// Every block is exposed on all six faces, the worst case for both meshers
+		corpora.push_back(CreateCorpus("checkerboard", FillBlocks([](int32_t x, uint32_t y, int32_t z)
+																  { return ((x + static_cast<int32_t>(y) + z) & 1) == 0 ? BlockIds::stone : BlockIds::air; })));
+
+		siv::PerlinNoise caves_noise(corpus_seed);
+		corpora.push_back(CreateCorpus("caves", FillBlocks([&caves_noise](int32_t x, uint32_t y, int32_t z)
+														   {
+															   if (y >= 48 || caves_noise.octave3D_01(x / 16.0, y / 16.0, z / 16.0, 2) > 0.6)
+															   {
+																   return BlockIds::air;
+															   }
+															   return y >= 45 ? BlockIds::dirt : BlockIds::stone;
+														   })));
+
+		return corpora;
+	}
+
+	ChunkNeighbors GetNeighbors(const Corpus &corpus, int32_t chunk_x, int32_t chunk_z)
+	{
+		auto get_neighbor = [&corpus](int32_t x, int32_t z) -> std::shared_ptr<Chunk>
+		{
+			if (x < 0 || x >= corpus_size || z < 0 || z >= corpus_size)
+			{
+				return nullptr;
+			}
+			return corpus.chunks[z * corpus_size + x];
+		};
+
+		return ChunkNeighbors{get_neighbor(chunk_x - 1, chunk_z), get_neighbor(chunk_x + 1, chunk_z), get_neighbor(chunk_x, chunk_z - 1), get_neighbor(chunk_x, chunk_z + 1)};
+	}
+
+	uint64_t MeshCorpus(ChunkMesher &chunk_mesher, const Corpus &corpus, const MeshingVariant &variant)
+	{
+		uint64_t quads_count = 0;
+		for (int32_t chunk_z = 0; chunk_z < corpus_size; ++chunk_z)
+		{
+			for (int32_t chunk_x = 0; chunk_x < corpus_size; ++chunk_x)
+			{
+				auto neighbors = variant.lod_level > 0 ? ChunkNeighbors() : GetNeighbors(corpus, chunk_x, chunk_z);
+				auto mesh = chunk_mesher.MeshChunk(*corpus.chunks[chunk_z * corpus_size + chunk_x], neighbors, CancellationToken(), Chunk::all_sections_mask, variant.lod_level);
+				quads_count += mesh->GetVerticesCount() / ChunkMesh::vertices_per_quad;
+			}
+		}
+		return quads_count;
+	}
+
+	BenchmarkResult Run(const Corpus &corpus, const MeshingVariant &variant, uint32_t iterations_count)
+	{
+		ChunkMesher chunk_mesher(variant.meshing_mode);
+		MeshCorpus(chunk_mesher, corpus, variant);
+
+		BenchmarkResult result{corpus.name, variant.name, 0, 0.0, 0, 0};
+		auto allocations_before = allocations_count.load();
+		auto start = std::chrono::steady_clock::now();
+
+		for (uint32_t iteration = 0; iteration < iterations_count; ++iteration)
+		{
+			result.quads_count += MeshCorpus(chunk_mesher, corpus, variant);
+			result.chunks_count += corpus.chunks.size();
+		}
+
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		result.allocations_count = allocations_count.load() - allocations_before;
+		return result;
+	}
+
+	void WriteJson(std::FILE *output, uint32_t iterations_count, const std::vector<BenchmarkResult> &results)
+	{
+		std::fprintf(output, "{\n");
+		std::fprintf(output, "  \"iterations\": %u,\n", iterations_count);
+		std::fprintf(output, "  \"chunks_per_corpus\": %d,\n", corpus_size * corpus_size);
+		std::fprintf(output, "  \"seed\": %llu,\n", static_cast<unsigned long long>(corpus_seed));
+		std::fprintf(output, "  \"face_culling\": \"%s\",\n", FaceCullingKernel::GetInstructionSet());
+		std::fprintf(output, "  \"results\": [\n");
+
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			auto &result = results[i];
+			auto chunks_count = static_cast<double>(result.chunks_count);
+			auto quads_per_chunk = static_cast<double>(result.quads_count) / chunks_count;
+
+			std::fprintf(output, "    {\"corpus\": \"%s\", \"variant\": \"%s\", \"chunks\": %llu, \"voxels_per_second\": %.0f, \"microseconds_per_chunk\": %.2f, \"quads_per_chunk\": %.1f, \"bytes_per_chunk\": %.1f, \"allocations_per_chunk\": %.2f}%s\n",
+						 result.corpus_name,
+						 result.variant_name,
+						 static_cast<unsigned long long>(result.chunks_count),
+						 chunks_count * chunk_volume / result.seconds,
+						 result.seconds * 1e6 / chunks_count,
+						 quads_per_chunk,
+						 quads_per_chunk * ChunkMesh::vertices_per_quad * sizeof(ChunkVertex),
+						 static_cast<double>(result.allocations_count) / chunks_count,
+						 i + 1 < results.size() ? "," : "");
+		}
+
+		std::fprintf(output, "  ]\n");
+		std::fprintf(output, "}\n");
+	}
+}
+
+int main(int argc, char **argv)
+{
+	try
+	{
+		uint32_t iterations_count = default_iterations_count;
+		const char *output_path = nullptr;
+
+		for (int i = 1; i < argc; ++i)
+		{
+			if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+			{
+				iterations_count = static_cast<uint32_t>(std::stoul(argv[++i]));
+			}
+			else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+			{
+				output_path = argv[++i];
+			}
+			else
+			{
+				throw std::runtime_error(std::string("Unknown argument ") + argv[i]);
+			}
+		}
+
+		const std::vector<MeshingVariant> variants = {
+			{"naive", MeshingMode::Naive, 0},
+			{"greedy", MeshingMode::Greedy, 0},
+			{"greedy_lod1", MeshingMode::Greedy, 1},
+			{"greedy_lod2", MeshingMode::Greedy, 2},
+			{"greedy_lod3", MeshingMode::Greedy, 3},
+		};
+
+		std::vector<BenchmarkResult> results;
+		for (auto &corpus : CreateCorpora())
+		{
+			for (auto &variant : variants)
+			{
+				results.push_back(Run(corpus, variant, iterations_count));
+			}
+		}
+
+		auto output = output_path != nullptr ? std::fopen(output_path, "w") : stdout;
+		if (output == nullptr)
+		{
+			throw std::runtime_error(std::string("Failed to open ") + output_path);
+		}
+
+		WriteJson(output, iterations_count, results);
+
+		if (output != stdout)
+		{
+			std::fclose(output);
+		}
+	}
+	catch (const std::exception &ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -36,9 +36,12 @@ SOFTWARE.
 #include "../src/plaincraft/common/events/event_listener.hpp"
 #include "../src/plaincraft/common/events/event_trigger.hpp"
 
+#include "../src/plaincraft/common/noise/perlin_noise_kernel.hpp"
+
 #include "../src/plaincraft/common/system_types_glm.hpp"
 #include "../src/plaincraft/common/system_types.hpp"
 
+#include "../src/plaincraft/common/utils/cancellation_token.hpp"
 #include "../src/plaincraft/common/utils/file_utils.hpp"
 #include "../src/plaincraft/common/utils/hash_utils.hpp"
 
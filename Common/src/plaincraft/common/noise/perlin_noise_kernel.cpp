@@ -0,0 +1,323 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "perlin_noise_kernel.hpp"
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PLAINCRAFT_NOISE_AVX2
+#elif defined(__SSE4_2__) || defined(PLAINCRAFT_SIMD_SSE42)
+#include <nmmintrin.h>
+#define PLAINCRAFT_NOISE_SSE42
+#endif
+
+namespace plaincraft_common
+{
+    namespace
+    {
+        // siv::PerlinNoise evaluates 2D noise as a 3D slice at this fixed depth
+        constexpr double noise_depth = 0.34567;
+
+        inline double Fade(double t)
+        {
+            return t * t * t * (t * (t * 6 - 15) + 10);
+        }
+
+        inline double Lerp(double a, double b, double t)
+        {
+            return a + (b - a) * t;
+        }
+
+        inline double Grad(int32_t hash, double x, double y, double z)
+        {
+            const int32_t h = hash & 15;
+            const double u = h < 8 ? x : y;
+            const double v = h < 4 ? y : h == 12 || h == 14 ? x : z;
+            return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
+        }
+
+        struct LatticeHashes
+        {
+            int32_t aa, ba, ab, bb;
+        };
+
+        inline LatticeHashes Hash(const int32_t *p, int32_t ix, int32_t iy)
+        {
+            const int32_t a = (p[ix] + iy) & 255;
+            const int32_t b = (p[(ix + 1) & 255] + iy) & 255;
+            return {p[a], p[b], p[(a + 1) & 255], p[(b + 1) & 255]};
+        }
+
+        inline double Noise2D(const int32_t *p, double x, double y)
+        {
+            const double floor_x = std::floor(x);
+            const double floor_y = std::floor(y);
+            const int32_t ix = static_cast<int32_t>(floor_x) & 255;
+            const int32_t iy = static_cast<int32_t>(floor_y) & 255;
+
+            const double fx = x - floor_x;
+            const double fy = y - floor_y;
+            const double fz = noise_depth;
+
+            const double u = Fade(fx);
+            const double v = Fade(fy);
+            const double w = Fade(fz);
+
+            const auto [aa, ba, ab, bb] = Hash(p, ix, iy);
+
+            const double q0 = Lerp(Grad(p[aa], fx, fy, fz), Grad(p[ba], fx - 1, fy, fz), u);
+            const double q1 = Lerp(Grad(p[ab], fx, fy - 1, fz), Grad(p[bb], fx - 1, fy - 1, fz), u);
+            const double q2 = Lerp(Grad(p[(aa + 1) & 255], fx, fy, fz - 1), Grad(p[(ba + 1) & 255], fx - 1, fy, fz - 1), u);
+            const double q3 = Lerp(Grad(p[(ab + 1) & 255], fx, fy - 1, fz - 1), Grad(p[(bb + 1) & 255], fx - 1, fy - 1, fz - 1), u);
+
+            return Lerp(Lerp(q0, q1, v), Lerp(q2, q3, v), w);
+        }
+
+#if defined(PLAINCRAFT_NOISE_AVX2)
+        constexpr uint32_t lanes_count = 4;
+
+        inline __m256d Fade(__m256d t)
+        {
+            const auto t3 = _mm256_mul_pd(_mm256_mul_pd(t, t), t);
+            const auto inner = _mm256_sub_pd(_mm256_mul_pd(t, _mm256_set1_pd(6.0)), _mm256_set1_pd(15.0));
+            return _mm256_mul_pd(t3, _mm256_add_pd(_mm256_mul_pd(t, inner), _mm256_set1_pd(10.0)));
+        }
+
+        inline __m256d Lerp(__m256d a, __m256d b, __m256d t)
+        {
+            return _mm256_add_pd(a, _mm256_mul_pd(_mm256_sub_pd(b, a), t));
+        }
+
+        inline __m256d Grad(__m128i hash, __m256d x, __m256d y, __m256d z)
+        {
+            const auto h = _mm256_cvtepi32_epi64(_mm_and_si128(hash, _mm_set1_epi32(15)));
+            const auto below_8 = _mm256_castsi256_pd(_mm256_cmpgt_epi64(_mm256_set1_epi64x(8), h));
+            const auto below_4 = _mm256_castsi256_pd(_mm256_cmpgt_epi64(_mm256_set1_epi64x(4), h));
+            const auto is_12_or_14 = _mm256_castsi256_pd(_mm256_or_si256(
+                _mm256_cmpeq_epi64(h, _mm256_set1_epi64x(12)),
+                _mm256_cmpeq_epi64(h, _mm256_set1_epi64x(14))));
+
+            const auto u = _mm256_blendv_pd(y, x, below_8);
+            const auto v = _mm256_blendv_pd(_mm256_blendv_pd(z, x, is_12_or_14), y, below_4);
+
+            const auto u_sign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(h, _mm256_set1_epi64x(1)), 63));
+            const auto v_sign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(h, _mm256_set1_epi64x(2)), 62));
+
+            return _mm256_add_pd(_mm256_xor_pd(u, u_sign), _mm256_xor_pd(v, v_sign));
+        }
+
+        inline __m128i Lookup(const int32_t *p, __m128i index)
+        {
+            return _mm_i32gather_epi32(p, _mm_and_si128(index, _mm_set1_epi32(255)), 4);
+        }
+
+        inline __m256d Noise2D(const int32_t *p, __m256d x, __m256d y)
+        {
+            const auto floor_x = _mm256_floor_pd(x);
+            const auto floor_y = _mm256_floor_pd(y);
+            const auto mask = _mm_set1_epi32(255);
+            const auto one = _mm_set1_epi32(1);
+            const auto ix = _mm_and_si128(_mm256_cvttpd_epi32(floor_x), mask);
+            const auto iy = _mm_and_si128(_mm256_cvttpd_epi32(floor_y), mask);
+
+            const auto fx = _mm256_sub_pd(x, floor_x);
+            const auto fy = _mm256_sub_pd(y, floor_y);
+            const auto fz = _mm256_set1_pd(noise_depth);
+            const auto fx1 = _mm256_sub_pd(fx, _mm256_set1_pd(1.0));
+            const auto fy1 = _mm256_sub_pd(fy, _mm256_set1_pd(1.0));
+            const auto fz1 = _mm256_set1_pd(noise_depth - 1);
+
+            const auto u = Fade(fx);
+            const auto v = Fade(fy);
+            const auto w = Fade(fz);
+
+            const auto a = _mm_and_si128(_mm_add_epi32(Lookup(p, ix), iy), mask);
+            const auto b = _mm_and_si128(_mm_add_epi32(Lookup(p, _mm_add_epi32(ix, one)), iy), mask);
+            const auto aa = Lookup(p, a);
+            const auto ba = Lookup(p, b);
+            const auto ab = Lookup(p, _mm_add_epi32(a, one));
+            const auto bb = Lookup(p, _mm_add_epi32(b, one));
+
+            const auto q0 = Lerp(Grad(Lookup(p, aa), fx, fy, fz), Grad(Lookup(p, ba), fx1, fy, fz), u);
+            const auto q1 = Lerp(Grad(Lookup(p, ab), fx, fy1, fz), Grad(Lookup(p, bb), fx1, fy1, fz), u);
+            const auto q2 = Lerp(Grad(Lookup(p, _mm_add_epi32(aa, one)), fx, fy, fz1), Grad(Lookup(p, _mm_add_epi32(ba, one)), fx1, fy, fz1), u);
+            const auto q3 = Lerp(Grad(Lookup(p, _mm_add_epi32(ab, one)), fx, fy1, fz1), Grad(Lookup(p, _mm_add_epi32(bb, one)), fx1, fy1, fz1), u);
+
+            return Lerp(Lerp(q0, q1, v), Lerp(q2, q3, v), w);
+        }
+#elif defined(PLAINCRAFT_NOISE_SSE42)
+        constexpr uint32_t lanes_count = 2;
+
+        inline __m128d Fade(__m128d t)
+        {
+            const auto t3 = _mm_mul_pd(_mm_mul_pd(t, t), t);
+            const auto inner = _mm_sub_pd(_mm_mul_pd(t, _mm_set1_pd(6.0)), _mm_set1_pd(15.0));
+            return _mm_mul_pd(t3, _mm_add_pd(_mm_mul_pd(t, inner), _mm_set1_pd(10.0)));
+        }
+
+        inline __m128d Lerp(__m128d a, __m128d b, __m128d t)
+        {
+            return _mm_add_pd(a, _mm_mul_pd(_mm_sub_pd(b, a), t));
+        }
+
+        inline __m128d Grad(int32_t first_hash, int32_t second_hash, __m128d x, __m128d y, __m128d z)
+        {
+            const auto h = _mm_set_epi64x(second_hash & 15, first_hash & 15);
+            const auto below_8 = _mm_castsi128_pd(_mm_cmpgt_epi64(_mm_set1_epi64x(8), h));
+            const auto below_4 = _mm_castsi128_pd(_mm_cmpgt_epi64(_mm_set1_epi64x(4), h));
+            const auto is_12_or_14 = _mm_castsi128_pd(_mm_or_si128(
+                _mm_cmpeq_epi64(h, _mm_set1_epi64x(12)),
+                _mm_cmpeq_epi64(h, _mm_set1_epi64x(14))));
+
+            const auto u = _mm_blendv_pd(y, x, below_8);
+            const auto v = _mm_blendv_pd(_mm_blendv_pd(z, x, is_12_or_14), y, below_4);
+
+            const auto u_sign = _mm_castsi128_pd(_mm_slli_epi64(_mm_and_si128(h, _mm_set1_epi64x(1)), 63));
+            const auto v_sign = _mm_castsi128_pd(_mm_slli_epi64(_mm_and_si128(h, _mm_set1_epi64x(2)), 62));
+
+            return _mm_add_pd(_mm_xor_pd(u, u_sign), _mm_xor_pd(v, v_sign));
+        }
+
+        inline __m128d Noise2D(const int32_t *p, __m128d x, __m128d y)
+        {
+            const auto floor_x = _mm_floor_pd(x);
+            const auto floor_y = _mm_floor_pd(y);
+
+            alignas(16) int32_t ix[4], iy[4];
+            _mm_store_si128(reinterpret_cast<__m128i *>(ix), _mm_cvttpd_epi32(floor_x));
+            _mm_store_si128(reinterpret_cast<__m128i *>(iy), _mm_cvttpd_epi32(floor_y));
+
+            const auto fx = _mm_sub_pd(x, floor_x);
+            const auto fy = _mm_sub_pd(y, floor_y);
+            const auto fz = _mm_set1_pd(noise_depth);
+            const auto fx1 = _mm_sub_pd(fx, _mm_set1_pd(1.0));
+            const auto fy1 = _mm_sub_pd(fy, _mm_set1_pd(1.0));
+            const auto fz1 = _mm_set1_pd(noise_depth - 1);
+
+            const auto u = Fade(fx);
+            const auto v = Fade(fy);
+            const auto w = Fade(fz);
+
+            const auto h0 = Hash(p, ix[0] & 255, iy[0] & 255);
+            const auto h1 = Hash(p, ix[1] & 255, iy[1] & 255);
+
+            const auto q0 = Lerp(Grad(p[h0.aa], p[h1.aa], fx, fy, fz), Grad(p[h0.ba], p[h1.ba], fx1, fy, fz), u);
+            const auto q1 = Lerp(Grad(p[h0.ab], p[h1.ab], fx, fy1, fz), Grad(p[h0.bb], p[h1.bb], fx1, fy1, fz), u);
+            const auto q2 = Lerp(Grad(p[(h0.aa + 1) & 255], p[(h1.aa + 1) & 255], fx, fy, fz1), Grad(p[(h0.ba + 1) & 255], p[(h1.ba + 1) & 255], fx1, fy, fz1), u);
+            const auto q3 = Lerp(Grad(p[(h0.ab + 1) & 255], p[(h1.ab + 1) & 255], fx, fy1, fz1), Grad(p[(h0.bb + 1) & 255], p[(h1.bb + 1) & 255], fx1, fy1, fz1), u);
+
+            return Lerp(Lerp(q0, q1, v), Lerp(q2, q3, v), w);
+        }
+#else
+        constexpr uint32_t lanes_count = 1;
+#endif
+    }
+
+    PerlinNoiseKernel::PerlinNoiseKernel(const Permutation &permutation)
+    {
+        for (size_t i = 0; i < permutation.size(); ++i)
+        {
+            permutation_[i] = permutation[i];
+        }
+    }
+
+    void PerlinNoiseKernel::NormalizedOctave2D01(double origin_x, double origin_z, double scale, int32_t octaves, double persistence, Grid &grid) const
+    {
+        grid.fill(0.0);
+
+        alignas(32) std::array<double, grid_size> x;
+        std::array<double, grid_size> z;
+        for (uint32_t i = 0; i < grid_size; ++i)
+        {
+            x[i] = (origin_x + i) / scale;
+            z[i] = (origin_z + i) / scale;
+        }
+
+        double amplitude = 1.0;
+        double max_amplitude = 0.0;
+        for (int32_t octave = 0; octave < octaves; ++octave)
+        {
+            for (uint32_t row = 0; row < grid_size; ++row)
+            {
+                AccumulateOctave(x.data(), z[row], amplitude, grid.data() + row * grid_size);
+                z[row] *= 2;
+            }
+
+            for (auto &value : x)
+            {
+                value *= 2;
+            }
+
+            max_amplitude += amplitude;
+            amplitude *= persistence;
+        }
+
+        for (auto &value : grid)
+        {
+            value = (value / max_amplitude) * 0.5 + 0.5;
+        }
+    }
+
+    const char *PerlinNoiseKernel::GetInstructionSet()
+    {
+#if defined(PLAINCRAFT_NOISE_AVX2)
+        return "AVX2";
+#elif defined(PLAINCRAFT_NOISE_SSE42)
+        return "SSE4.2";
+#else
+        return "None";
+#endif
+    }
+
+    void PerlinNoiseKernel::AccumulateOctave(const double *x, double y, double amplitude, double *result) const
+    {
+        const auto p = permutation_.data();
+
+#if defined(PLAINCRAFT_NOISE_AVX2)
+        const auto y_vector = _mm256_set1_pd(y);
+        const auto amplitude_vector = _mm256_set1_pd(amplitude);
+        for (uint32_t i = 0; i < grid_size; i += lanes_count)
+        {
+            const auto noise = Noise2D(p, _mm256_load_pd(x + i), y_vector);
+            _mm256_storeu_pd(result + i, _mm256_add_pd(_mm256_loadu_pd(result + i), _mm256_mul_pd(noise, amplitude_vector)));
+        }
+#elif defined(PLAINCRAFT_NOISE_SSE42)
+        const auto y_vector = _mm_set1_pd(y);
+        const auto amplitude_vector = _mm_set1_pd(amplitude);
+        for (uint32_t i = 0; i < grid_size; i += lanes_count)
+        {
+            const auto noise = Noise2D(p, _mm_load_pd(x + i), y_vector);
+            _mm_storeu_pd(result + i, _mm_add_pd(_mm_loadu_pd(result + i), _mm_mul_pd(noise, amplitude_vector)));
+        }
+#else
+        for (uint32_t i = 0; i < grid_size; ++i)
+        {
+            result[i] += Noise2D(p, x[i], y) * amplitude;
+        }
+#endif
+    }
+}
@@ -0,0 +1,65 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_COMMON_PERLIN_NOISE_KERNEL
+#define PLAINCRAFT_COMMON_PERLIN_NOISE_KERNEL
+
+#include <array>
+#include <cstdint>
+
+namespace plaincraft_common
+{
+    // Vectorized evaluation of siv::PerlinNoise::normalizedOctave2D_01 over a 16x16 grid.
+    // The AVX2 (4 lanes) and SSE4.2 (2 lanes) paths use double precision and repeat the scalar
+    // operations in the same order, so results match siv::PerlinNoise to within 1e-12
+    // (bit-exact unless the compiler contracts the scalar reference into FMA instructions).
+    class PerlinNoiseKernel final
+    {
+    public:
+        static constexpr uint32_t grid_size = 16;
+        static constexpr double tolerance = 1e-12;
+
+        using Permutation = std::array<uint8_t, 256>;
+        using Grid = std::array<double, grid_size * grid_size>;
+
+    private:
+        alignas(32) std::array<int32_t, 256> permutation_;
+
+    public:
+        // Accepts the state returned by siv::PerlinNoise::serialize()
+        explicit PerlinNoiseKernel(const Permutation &permutation);
+
+        // Fills grid[z * grid_size + x] with normalizedOctave2D_01((origin_x + x) / scale, (origin_z + z) / scale, octaves, persistence)
+        void NormalizedOctave2D01(double origin_x, double origin_z, double scale, int32_t octaves, double persistence, Grid &grid) const;
+
+        static const char *GetInstructionSet();
+
+    private:
+        void AccumulateOctave(const double *x, double y, double amplitude, double *result) const;
+    };
+}
+
+#endif // PLAINCRAFT_COMMON_PERLIN_NOISE_KERNEL
@@ -0,0 +1,66 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_COMMON_CANCELLATION_TOKEN
+#define PLAINCRAFT_COMMON_CANCELLATION_TOKEN
+
+#include <atomic>
+#include <memory>
+
+namespace plaincraft_common
+{
+    // Shared flag polled by long running jobs, a default constructed token can never be cancelled
+    class CancellationToken
+    {
+    private:
+        std::shared_ptr<std::atomic<bool>> is_cancelled_;
+
+    public:
+        CancellationToken() = default;
+
+        static CancellationToken Create()
+        {
+            CancellationToken result;
+            result.is_cancelled_ = std::make_shared<std::atomic<bool>>(false);
+            return result;
+        }
+
+        void Cancel() const
+        {
+            if (is_cancelled_ != nullptr)
+            {
+                is_cancelled_->store(true, std::memory_order_relaxed);
+            }
+        }
+
+        bool IsCancelled() const
+        {
+            return is_cancelled_ != nullptr && is_cancelled_->load(std::memory_order_relaxed);
+        }
+    };
+}
+
+#endif // PLAINCRAFT_COMMON_CANCELLATION_TOKEN
@@ -33,4 +33,7 @@ SOFTWARE.
 #include "../src/plaincraft/core/scene/scene.hpp"
 #include "../src/plaincraft/core/game.hpp"
 
+#include "../src/plaincraft/core/world/chunk_mesher.hpp"
+#include "../src/plaincraft/core/world/chunks/chunk_builder.hpp"
+
 #endif // PLAINCRAFT_CORE_PLAINCRAFT_CORE
\ No newline at end of file
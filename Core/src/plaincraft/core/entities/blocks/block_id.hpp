@@ -24,20 +24,21 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
-#ifndef PLAINCRAFT_BLOCKS_DIRT
-#define PLAINCRAFT_BLOCKS_DIRT
+#ifndef PLAINCRAFT_CORE_BLOCK_ID
+#define PLAINCRAFT_CORE_BLOCK_ID
 
-#include "./block.hpp"
+#include <cstdint>
 
 namespace plaincraft_core
 {
-    class Dirt : public Block
-    {
-        public:
-            Dirt();
+    using BlockId = uint16_t;
 
-            const TextureCoordinates& GetTextureCoordinates() const override;
+    struct BlockIds
+    {
+        static constexpr BlockId air = 0;
+        static constexpr BlockId stone = 1;
+        static constexpr BlockId dirt = 2;
     };
 }
 
-#endif // PLAINCRAFT_BLOCKS_DIRT
\ No newline at end of file
+#endif // PLAINCRAFT_CORE_BLOCK_ID
@@ -0,0 +1,133 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_CORE_BLOCK_REGISTRY
+#define PLAINCRAFT_CORE_BLOCK_REGISTRY
+
+#include "block_id.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace plaincraft_core
+{
+    enum BlockFace : uint8_t
+    {
+        Top = 0,
+        Bottom = 1,
+        Left = 2,
+        Right = 3,
+        Front = 4,
+        Back = 5
+    };
+
+    constexpr size_t block_faces_count = 6;
+
+    struct BlockTextureTile
+    {
+        uint8_t column;
+        uint8_t row;
+    };
+
+    // Bounds relative to the block center, a full block spans -0.5 to 0.5 on every axis
+    struct BlockCollisionBox
+    {
+        float min_x, min_y, min_z;
+        float max_x, max_y, max_z;
+    };
+
+    using BlockFaceTextures = std::array<BlockTextureTile, block_faces_count>;
+
+    struct BlockDefinition
+    {
+        BlockId id;
+        const char *name;
+        BlockFaceTextures face_textures;
+        bool is_solid;
+        bool is_opaque;
+        BlockCollisionBox collision_box;
+        float friction;
+    };
+
+    namespace built_in_blocks
+    {
+        constexpr BlockCollisionBox no_collision_box{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+        constexpr BlockCollisionBox full_collision_box{-0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f};
+
+        constexpr std::array<BlockDefinition, 3> definitions{{
+            {BlockIds::air, "air", {}, false, false, no_collision_box, 1.0f},
+            {BlockIds::stone, "stone", {{{1, 0}, {1, 0}, {1, 0}, {1, 0}, {1, 0}, {1, 0}}}, true, true, full_collision_box, 1.0f},
+            {BlockIds::dirt, "dirt", {{{0, 0}, {2, 0}, {3, 0}, {3, 0}, {3, 0}, {3, 0}}}, true, true, full_collision_box, 1.0f},
+        }};
+
+        template <typename TValue, typename TSelector>
+        constexpr std::array<TValue, definitions.size()> BuildTable(TSelector selector)
+        {
+            std::array<TValue, definitions.size()> table{};
+            for (const auto &definition : definitions)
+            {
+                table[definition.id] = selector(definition);
+            }
+            return table;
+        }
+    }
+
+    // Flyweight block properties, stored as one table per property and indexed by BlockId
+    class BlockRegistry final
+    {
+    public:
+        static constexpr size_t blocks_count = built_in_blocks::definitions.size();
+
+        static constexpr std::array<BlockFaceTextures, blocks_count> face_textures = built_in_blocks::BuildTable<BlockFaceTextures>(
+            [](const BlockDefinition &definition)
+            { return definition.face_textures; });
+
+        static constexpr std::array<bool, blocks_count> is_solid = built_in_blocks::BuildTable<bool>(
+            [](const BlockDefinition &definition)
+            { return definition.is_solid; });
+
+        static constexpr std::array<bool, blocks_count> is_opaque = built_in_blocks::BuildTable<bool>(
+            [](const BlockDefinition &definition)
+            { return definition.is_opaque; });
+
+        static constexpr std::array<BlockCollisionBox, blocks_count> collision_boxes = built_in_blocks::BuildTable<BlockCollisionBox>(
+            [](const BlockDefinition &definition)
+            { return definition.collision_box; });
+
+        static constexpr std::array<float, blocks_count> friction = built_in_blocks::BuildTable<float>(
+            [](const BlockDefinition &definition)
+            { return definition.friction; });
+
+        static constexpr std::array<const char *, blocks_count> names = built_in_blocks::BuildTable<const char *>(
+            [](const BlockDefinition &definition)
+            { return definition.name; });
+    };
+
+    static_assert(BlockRegistry::is_opaque[BlockIds::air] == false, "Air has to be transparent");
+    static_assert(BlockRegistry::is_solid[BlockIds::air] == false, "Air can not collide");
+}
+
+#endif // PLAINCRAFT_CORE_BLOCK_REGISTRY
@@ -27,6 +27,8 @@ SOFTWARE.
 #include "chunk.hpp"
 #include <iostream>
 #include <set>
+#include <cstring>
+#include <stdexcept>
 
 namespace plaincraft_core
 {
@@ -67,11 +69,117 @@ namespace plaincraft_core
         return pos_z_;
     }
 
+    BlockId Chunk::GetBlock(uint32_t x, uint32_t y, uint32_t z) const
+    {
+        return blocks_[y / ChunkSection::section_size].GetBlock(x, y % ChunkSection::section_size, z);
+    }
+
+    void Chunk::SetBlock(uint32_t x, uint32_t y, uint32_t z, BlockId block_id)
+    {
+        blocks_[y / ChunkSection::section_size].SetBlock(x, y % ChunkSection::section_size, z, block_id);
+    }
+
+    Chunk::SectionsMask Chunk::EditBlock(uint32_t x, uint32_t y, uint32_t z, BlockId block_id)
+    {
+        std::unique_lock lk(blocks_mutex_);
+        if (GetBlock(x, y, z) == block_id)
+        {
+            return 0;
+        }
+
+        SetBlock(x, y, z, block_id);
+        lk.unlock();
+
+        // Blocks on a section border also change the faces of the section next to them
+        auto section_index = y / ChunkSection::section_size;
+        auto section_y = y % ChunkSection::section_size;
+        auto sections_mask = static_cast<SectionsMask>(1) << section_index;
+        if (section_y == 0 && section_index > 0)
+        {
+            sections_mask |= static_cast<SectionsMask>(1) << (section_index - 1);
+        }
+        if (section_y == ChunkSection::section_size - 1 && section_index < sections_count - 1)
+        {
+            sections_mask |= static_cast<SectionsMask>(1) << (section_index + 1);
+        }
+
+        MarkSectionsDirty(sections_mask);
+        return sections_mask;
+    }
+
+    void Chunk::MarkSectionsDirty(SectionsMask sections_mask)
+    {
+        dirty_sections_.fetch_or(sections_mask);
+    }
+
+    Chunk::SectionsMask Chunk::TakeDirtySections()
+    {
+        return dirty_sections_.exchange(0);
+    }
+
+    bool Chunk::HasDirtySections() const
+    {
+        return dirty_sections_.load() != 0;
+    }
+
+    const ChunkSection &Chunk::GetSection(uint32_t section_index) const
+    {
+        return blocks_[section_index];
+    }
+
     Chunk::Data &Chunk::GetData()
     {
         return blocks_;
     }
 
+    void Chunk::Serialize(std::vector<uint8_t> &output) const
+    {
+        SectionsMask sections_mask = 0;
+        for (uint32_t section_index = 0; section_index < sections_count; ++section_index)
+        {
+            if (!blocks_[section_index].IsEmpty())
+            {
+                sections_mask |= static_cast<SectionsMask>(1) << section_index;
+            }
+        }
+
+        auto mask_bytes = reinterpret_cast<const uint8_t *>(&sections_mask);
+        output.insert(output.end(), mask_bytes, mask_bytes + sizeof(sections_mask));
+
+        for (uint32_t section_index = 0; section_index < sections_count; ++section_index)
+        {
+            if (sections_mask & (static_cast<SectionsMask>(1) << section_index))
+            {
+                blocks_[section_index].Serialize(output);
+            }
+        }
+    }
+
+    void Chunk::Deserialize(const std::vector<uint8_t> &input)
+    {
+        if (input.size() < sizeof(SectionsMask))
+        {
+            throw std::runtime_error("Unexpected end of chunk data");
+        }
+
+        SectionsMask sections_mask;
+        std::memcpy(&sections_mask, input.data(), sizeof(sections_mask));
+
+        auto input_position = input.data() + sizeof(sections_mask);
+        auto input_end = input.data() + input.size();
+
+        Data blocks;
+        for (uint32_t section_index = 0; section_index < sections_count; ++section_index)
+        {
+            if (sections_mask & (static_cast<SectionsMask>(1) << section_index))
+            {
+                blocks[section_index] = ChunkSection::Deserialize(input_position, input_end);
+            }
+        }
+
+        blocks_ = std::move(blocks);
+    }
+
     void Chunk::InitializeName()
     {
         auto size = std::snprintf(nullptr, 0, chunk_model_name_template, pos_x_, pos_z_) + 1;
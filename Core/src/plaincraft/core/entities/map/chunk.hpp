@@ -27,9 +27,14 @@ SOFTWARE.
 #ifndef PLAINCRAFT_CORE_CHUNK
 #define PLAINCRAFT_CORE_CHUNK
 
-#include "../blocks/block.hpp"
+#include "../game_object.hpp"
+#include "../blocks/block_id.hpp"
+#include "chunk_section.hpp"
 #include <plaincraft_render_engine.hpp>
 #include <array>
+#include <atomic>
+#include <shared_mutex>
+#include <vector>
 
 namespace plaincraft_core
 {
@@ -37,25 +42,34 @@ namespace plaincraft_core
 
     class ModelsCache;
     class WorldOptimizer;
+    class ChunkMesher;
     class ChunkBuilder;
     class SimpleChunkBuilder;
 
     class Chunk : public GameObject
     {
         friend class WorldOptimizer;
+        friend class ChunkMesher;
         friend class ChunkBuilder;
         friend class SimpleChunkBuilder;
         friend class ChunksProcessor;
+        friend class Map;
 
     public:
         static constexpr uint32_t chunk_size = 16;
         static constexpr uint32_t chunk_height = 64;
+        static constexpr uint32_t sections_count = chunk_height / ChunkSection::section_size;
 
         static constexpr const char *chunk_model_name_template = "Chunk_%d_%d";
 
-        using Data = std::array<std::array<std::array<std::shared_ptr<Block>, chunk_size>, chunk_height>, chunk_size>;
+        using Data = std::array<ChunkSection, sections_count>;
+        using SectionsMask = uint32_t;
 
-    bool initialized_ = false;
+        static_assert(sections_count <= sizeof(SectionsMask) * 8, "Sections mask is too narrow for the chunk height");
+
+        static constexpr SectionsMask all_sections_mask = ~static_cast<SectionsMask>(0) >> (sizeof(SectionsMask) * 8 - sections_count);
+
+    std::atomic<bool> initialized_ = false;
 
     private:
         Data blocks_;
@@ -63,6 +77,10 @@ namespace plaincraft_core
         int32_t pos_x_, pos_z_;
         std::shared_ptr<Drawable> mesh_;
 
+        // Edits happen on the main thread while meshing workers read the blocks
+        mutable std::shared_mutex blocks_mutex_;
+        std::atomic<SectionsMask> dirty_sections_ = 0;
+
     public:
         Chunk(int32_t position_x, int32_t position_z);
 
@@ -75,8 +93,23 @@ namespace plaincraft_core
         int32_t GetPositionX() const;
         int32_t GetPositionZ() const;
 
+        BlockId GetBlock(uint32_t x, uint32_t y, uint32_t z) const;
+        void SetBlock(uint32_t x, uint32_t y, uint32_t z, BlockId block_id);
+
+        // Sets a block of a generated chunk and returns the sections whose faces it changed
+        SectionsMask EditBlock(uint32_t x, uint32_t y, uint32_t z, BlockId block_id);
+
+        void MarkSectionsDirty(SectionsMask sections_mask);
+        SectionsMask TakeDirtySections();
+        bool HasDirtySections() const;
+
+        const ChunkSection &GetSection(uint32_t section_index) const;
+
         Data &GetData();
 
+        void Serialize(std::vector<uint8_t> &output) const;
+        void Deserialize(const std::vector<uint8_t> &input);
+
     private:
         void InitializeName();
     };
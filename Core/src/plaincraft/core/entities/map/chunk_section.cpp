@@ -0,0 +1,236 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "chunk_section.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace plaincraft_core
+{
+    ChunkSection::ChunkSection()
+        : palette_{BlockIds::air}
+    {
+    }
+
+    BlockId ChunkSection::GetBlock(uint32_t x, uint32_t y, uint32_t z) const
+    {
+        if (bits_per_index_ == 0)
+        {
+            return palette_[0];
+        }
+
+        return palette_[ReadIndex(indices_, bits_per_index_, GetPosition(x, y, z))];
+    }
+
+    void ChunkSection::SetBlock(uint32_t x, uint32_t y, uint32_t z, BlockId block_id)
+    {
+        auto previous_block_id = GetBlock(x, y, z);
+        if (previous_block_id == block_id)
+        {
+            return;
+        }
+
+        if (previous_block_id == BlockIds::air)
+        {
+            ++non_air_blocks_count_;
+        }
+        else if (block_id == BlockIds::air && --non_air_blocks_count_ == 0)
+        {
+            Fill(BlockIds::air);
+            return;
+        }
+
+        auto palette_index = GetPaletteIndex(block_id);
+        WriteIndex(indices_, bits_per_index_, GetPosition(x, y, z), palette_index);
+    }
+
+    void ChunkSection::Fill(BlockId block_id)
+    {
+        palette_.assign(1, block_id);
+        indices_.clear();
+        indices_.shrink_to_fit();
+        bits_per_index_ = 0;
+        non_air_blocks_count_ = block_id == BlockIds::air ? 0 : section_volume;
+    }
+
+    bool ChunkSection::IsEmpty() const
+    {
+        return non_air_blocks_count_ == 0;
+    }
+
+    bool ChunkSection::IsUniform() const
+    {
+        return bits_per_index_ == 0;
+    }
+
+    uint32_t ChunkSection::GetNonAirBlocksCount() const
+    {
+        return non_air_blocks_count_;
+    }
+
+    size_t ChunkSection::GetMemoryUsage() const
+    {
+        return sizeof(ChunkSection) + palette_.capacity() * sizeof(BlockId) + indices_.capacity() * sizeof(uint64_t);
+    }
+
+    void ChunkSection::Serialize(std::vector<uint8_t> &output) const
+    {
+        auto palette_size = static_cast<uint16_t>(palette_.size());
+        auto bits_per_index = static_cast<uint8_t>(bits_per_index_);
+
+        Write(output, &palette_size, sizeof(palette_size));
+        Write(output, palette_.data(), palette_.size() * sizeof(BlockId));
+        Write(output, &bits_per_index, sizeof(bits_per_index));
+        Write(output, indices_.data(), indices_.size() * sizeof(uint64_t));
+    }
+
+    ChunkSection ChunkSection::Deserialize(const uint8_t *&input, const uint8_t *input_end)
+    {
+        ChunkSection section;
+
+        uint16_t palette_size;
+        Read(input, input_end, &palette_size, sizeof(palette_size));
+        if (palette_size == 0)
+        {
+            throw std::runtime_error("Chunk section palette can not be empty");
+        }
+
+        section.palette_.resize(palette_size);
+        Read(input, input_end, section.palette_.data(), palette_size * sizeof(BlockId));
+
+        uint8_t bits_per_index;
+        Read(input, input_end, &bits_per_index, sizeof(bits_per_index));
+        if (bits_per_index > 16 || (bits_per_index & (bits_per_index - 1)) != 0 || (bits_per_index == 0 && palette_size != 1))
+        {
+            throw std::runtime_error("Invalid chunk section index width");
+        }
+
+        section.bits_per_index_ = bits_per_index;
+        if (bits_per_index == 0)
+        {
+            section.non_air_blocks_count_ = section.palette_[0] == BlockIds::air ? 0 : section_volume;
+            return section;
+        }
+
+        section.indices_.resize(section_volume * bits_per_index / 64);
+        Read(input, input_end, section.indices_.data(), section.indices_.size() * sizeof(uint64_t));
+
+        for (uint32_t position = 0; position < section_volume; ++position)
+        {
+            auto palette_index = ReadIndex(section.indices_, bits_per_index, position);
+            if (palette_index >= palette_size)
+            {
+                throw std::runtime_error("Chunk section palette index out of range");
+            }
+
+            if (section.palette_[palette_index] != BlockIds::air)
+            {
+                ++section.non_air_blocks_count_;
+            }
+        }
+
+        return section;
+    }
+
+    uint32_t ChunkSection::GetPosition(uint32_t x, uint32_t y, uint32_t z)
+    {
+        return (y * section_size + z) * section_size + x;
+    }
+
+    uint32_t ChunkSection::ReadIndex(const std::vector<uint64_t> &indices, uint32_t bits_per_index, uint32_t position)
+    {
+        auto bit_position = position * bits_per_index;
+        auto mask = (static_cast<uint64_t>(1) << bits_per_index) - 1;
+        return static_cast<uint32_t>((indices[bit_position >> 6] >> (bit_position & 63)) & mask);
+    }
+
+    void ChunkSection::WriteIndex(std::vector<uint64_t> &indices, uint32_t bits_per_index, uint32_t position, uint32_t palette_index)
+    {
+        auto bit_position = position * bits_per_index;
+        auto shift = bit_position & 63;
+        auto mask = ((static_cast<uint64_t>(1) << bits_per_index) - 1) << shift;
+        auto &word = indices[bit_position >> 6];
+        word = (word & ~mask) | ((static_cast<uint64_t>(palette_index) << shift) & mask);
+    }
+
+    void ChunkSection::Write(std::vector<uint8_t> &output, const void *data, size_t size)
+    {
+        auto bytes = static_cast<const uint8_t *>(data);
+        output.insert(output.end(), bytes, bytes + size);
+    }
+
+    void ChunkSection::Read(const uint8_t *&input, const uint8_t *input_end, void *data, size_t size)
+    {
+        if (static_cast<size_t>(input_end - input) < size)
+        {
+            throw std::runtime_error("Unexpected end of chunk section data");
+        }
+
+        std::memcpy(data, input, size);
+        input += size;
+    }
+
+    uint32_t ChunkSection::GetPaletteIndex(BlockId block_id)
+    {
+        auto palette_entry = std::find(palette_.begin(), palette_.end(), block_id);
+        if (palette_entry != palette_.end())
+        {
+            return static_cast<uint32_t>(std::distance(palette_.begin(), palette_entry));
+        }
+
+        palette_.push_back(block_id);
+
+        uint32_t required_bits = 1;
+        while ((static_cast<size_t>(1) << required_bits) < palette_.size())
+        {
+            required_bits <<= 1;
+        }
+
+        if (required_bits > bits_per_index_)
+        {
+            Resize(required_bits);
+        }
+
+        return static_cast<uint32_t>(palette_.size() - 1);
+    }
+
+    void ChunkSection::Resize(uint32_t bits_per_index)
+    {
+        std::vector<uint64_t> indices(section_volume * bits_per_index / 64, 0);
+
+        if (bits_per_index_ != 0)
+        {
+            for (uint32_t position = 0; position < section_volume; ++position)
+            {
+                WriteIndex(indices, bits_per_index, position, ReadIndex(indices_, bits_per_index_, position));
+            }
+        }
+
+        indices_ = std::move(indices);
+        bits_per_index_ = bits_per_index;
+    }
+}
@@ -0,0 +1,81 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_CORE_CHUNK_SECTION
+#define PLAINCRAFT_CORE_CHUNK_SECTION
+
+#include "../blocks/block_id.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace plaincraft_core
+{
+    class ChunkSection
+    {
+    public:
+        static constexpr uint32_t section_size = 16;
+        static constexpr uint32_t section_volume = section_size * section_size * section_size;
+
+    private:
+        // Blocks are stored as indices into the palette, packed into 64-bit words.
+        // Index width is always a power of two so that no index spans two words,
+        // with 0 bits meaning the whole section is filled with palette_[0].
+        std::vector<BlockId> palette_;
+        std::vector<uint64_t> indices_;
+        uint32_t bits_per_index_ = 0;
+        uint32_t non_air_blocks_count_ = 0;
+
+    public:
+        ChunkSection();
+
+        BlockId GetBlock(uint32_t x, uint32_t y, uint32_t z) const;
+        void SetBlock(uint32_t x, uint32_t y, uint32_t z, BlockId block_id);
+        void Fill(BlockId block_id);
+
+        bool IsEmpty() const;
+        bool IsUniform() const;
+        uint32_t GetNonAirBlocksCount() const;
+
+        size_t GetMemoryUsage() const;
+
+        void Serialize(std::vector<uint8_t> &output) const;
+        static ChunkSection Deserialize(const uint8_t *&input, const uint8_t *input_end);
+
+    private:
+        static uint32_t GetPosition(uint32_t x, uint32_t y, uint32_t z);
+        static uint32_t ReadIndex(const std::vector<uint64_t> &indices, uint32_t bits_per_index, uint32_t position);
+        static void WriteIndex(std::vector<uint64_t> &indices, uint32_t bits_per_index, uint32_t position, uint32_t palette_index);
+
+        static void Write(std::vector<uint8_t> &output, const void *data, size_t size);
+        static void Read(const uint8_t *&input, const uint8_t *input_end, void *data, size_t size);
+
+        uint32_t GetPaletteIndex(BlockId block_id);
+        void Resize(uint32_t bits_per_index);
+    };
+}
+
+#endif // PLAINCRAFT_CORE_CHUNK_SECTION
@@ -33,20 +33,146 @@ namespace plaincraft_core
 {
     Map::Map()
     {
-        grid_ = Map::ChunksGrid(Map::render_diameter);
-        for (auto &row : grid_)
+    }
+
+    std::shared_ptr<Chunk> Map::GetChunk(int32_t chunk_x, int32_t chunk_z) const
+    {
+        std::shared_lock lk(map_mutex_);
+        if (!IsInWindow(chunk_x, chunk_z))
+        {
+            return nullptr;
+        }
+
+        return grid_[GetSlot(chunk_x)][GetSlot(chunk_z)];
+    }
+
+    bool Map::Contains(int32_t chunk_x, int32_t chunk_z) const
+    {
+        std::shared_lock lk(map_mutex_);
+        return IsInWindow(chunk_x, chunk_z);
+    }
+
+    BlockId Map::GetBlock(int32_t x, int32_t y, int32_t z) const
+    {
+        if (y < 0 || y >= static_cast<int32_t>(Chunk::chunk_height))
+        {
+            return BlockIds::air;
+        }
+
+        auto chunk_x = GetChunkCoordinate(x);
+        auto chunk_z = GetChunkCoordinate(z);
+        auto chunk = GetChunk(chunk_x, chunk_z);
+        if (chunk == nullptr || !chunk->initialized_)
+        {
+            return BlockIds::air;
+        }
+
+        std::shared_lock lk(chunk->blocks_mutex_);
+        return chunk->GetBlock(x - chunk_x * static_cast<int32_t>(Chunk::chunk_size), y, z - chunk_z * static_cast<int32_t>(Chunk::chunk_size));
+    }
+
+    std::vector<std::shared_ptr<Chunk>> Map::SetBlock(int32_t x, int32_t y, int32_t z, BlockId block_id)
+    {
+        std::vector<std::shared_ptr<Chunk>> edited_chunks;
+        if (y < 0 || y >= static_cast<int32_t>(Chunk::chunk_height))
+        {
+            return edited_chunks;
+        }
+
+        auto chunk_x = GetChunkCoordinate(x);
+        auto chunk_z = GetChunkCoordinate(z);
+        auto chunk = GetChunk(chunk_x, chunk_z);
+        if (chunk == nullptr || !chunk->initialized_)
+        {
+            return edited_chunks;
+        }
+
+        auto local_x = static_cast<uint32_t>(x - chunk_x * static_cast<int32_t>(Chunk::chunk_size));
+        auto local_z = static_cast<uint32_t>(z - chunk_z * static_cast<int32_t>(Chunk::chunk_size));
+        if (chunk->EditBlock(local_x, static_cast<uint32_t>(y), local_z, block_id) == 0)
+        {
+            return edited_chunks;
+        }
+
+        edited_chunks.push_back(chunk);
+
+        // Faces between chunks belong to both of them, neighbors only need the section at the same height
+        auto mark_neighbor = [&](int32_t neighbor_x, int32_t neighbor_z)
+        {
+            auto neighbor = GetChunk(neighbor_x, neighbor_z);
+            if (neighbor != nullptr && neighbor->initialized_)
+            {
+                neighbor->MarkSectionsDirty(static_cast<Chunk::SectionsMask>(1) << (y / ChunkSection::section_size));
+                edited_chunks.push_back(neighbor);
+            }
+        };
+
+        if (local_x == 0)
+        {
+            mark_neighbor(chunk_x - 1, chunk_z);
+        }
+        if (local_x == Chunk::chunk_size - 1)
+        {
+            mark_neighbor(chunk_x + 1, chunk_z);
+        }
+        if (local_z == 0)
         {
-            row = Map::ChunksRow(Map::render_diameter);
+            mark_neighbor(chunk_x, chunk_z - 1);
         }
+        if (local_z == Chunk::chunk_size - 1)
+        {
+            mark_neighbor(chunk_x, chunk_z + 1);
+        }
+
+        return edited_chunks;
+    }
+
+    bool Map::IsInitialized() const
+    {
+        std::shared_lock lk(map_mutex_);
+        return is_initialized_;
+    }
+
+    int32_t Map::GetStartX() const
+    {
+        std::shared_lock lk(map_mutex_);
+        return start_x_;
+    }
+
+    int32_t Map::GetStartZ() const
+    {
+        std::shared_lock lk(map_mutex_);
+        return start_z_;
+    }
+
+    void Map::SetChunk(int32_t chunk_x, int32_t chunk_z, std::shared_ptr<Chunk> chunk)
+    {
+        std::unique_lock lk(map_mutex_);
+        grid_[GetSlot(chunk_x)][GetSlot(chunk_z)] = std::move(chunk);
+    }
+
+    void Map::SetStart(int32_t start_x, int32_t start_z)
+    {
+        std::unique_lock lk(map_mutex_);
+        start_x_ = start_x;
+        start_z_ = start_z;
+        is_initialized_ = true;
+    }
+
+    bool Map::IsInWindow(int32_t chunk_x, int32_t chunk_z) const
+    {
+        return is_initialized_ && chunk_x >= start_x_ && chunk_x < start_x_ + static_cast<int32_t>(render_diameter) && chunk_z >= start_z_ && chunk_z < start_z_ + static_cast<int32_t>(render_diameter);
     }
 
-    Map::ChunksRow &Map::operator[](int block_index)
+    int32_t Map::GetChunkCoordinate(int32_t coordinate)
     {
-        return grid_[block_index];
+        constexpr auto chunk_size = static_cast<int32_t>(Chunk::chunk_size);
+        return coordinate >= 0 ? coordinate / chunk_size : (coordinate + 1) / chunk_size - 1;
     }
 
-    const Map::ChunksGrid &Map::GetGrid() const
+    uint32_t Map::GetSlot(int32_t chunk_coordinate)
     {
-        return grid_;
+        constexpr auto diameter = static_cast<int32_t>(render_diameter);
+        return static_cast<uint32_t>((chunk_coordinate % diameter + diameter) % diameter);
     }
 }
\ No newline at end of file
@@ -29,6 +29,9 @@ SOFTWARE.
 
 #include "../game_object.hpp"
 #include "chunk.hpp"
+#include <array>
+#include <memory>
+#include <shared_mutex>
 #include <vector>
 
 namespace plaincraft_core
@@ -36,30 +39,51 @@ namespace plaincraft_core
     class WorldGenerator;
     class WorldOptimizer;
 
+    // Chunks around the origin kept in a toroidal ring buffer, a chunk lives in the slot
+    // given by its world chunk coordinates modulo the render diameter
     class Map : public GameObject
     {
         friend class WorldGenerator;
         friend class WorldOptimizer;
 
+    public:
+        static constexpr uint32_t render_radius = 8;
+        static constexpr uint32_t render_diameter = render_radius * 2;
+        static constexpr uint32_t simulation_radius = 2;
+
     private:
-        using ChunksRow = std::vector<std::shared_ptr<Chunk>>;
-        using ChunksGrid = std::vector<ChunksRow>;
+        using ChunksGrid = std::array<std::array<std::shared_ptr<Chunk>, render_diameter>, render_diameter>;
+
+        // Chunk workers read neighbors while the window moves on the main thread
+        mutable std::shared_mutex map_mutex_;
 
         bool is_initialized_ = false;
+        int32_t start_x_ = 0;
+        int32_t start_z_ = 0;
+        ChunksGrid grid_;
 
     public:
+        Map();
 
-        static constexpr uint32_t render_radius = 4;
-        static constexpr uint32_t render_diameter = render_radius * 2;
-        static constexpr uint32_t simulation_radius = 2;
+        std::shared_ptr<Chunk> GetChunk(int32_t chunk_x, int32_t chunk_z) const;
+        bool Contains(int32_t chunk_x, int32_t chunk_z) const;
 
-        Map();
+        // Blocks in world coordinates, only chunks that are already generated can be edited
+        BlockId GetBlock(int32_t x, int32_t y, int32_t z) const;
+        std::vector<std::shared_ptr<Chunk>> SetBlock(int32_t x, int32_t y, int32_t z, BlockId block_id);
 
-        ChunksRow& operator[](int block_index);
-        const ChunksGrid& GetGrid() const;
+        bool IsInitialized() const;
+        int32_t GetStartX() const;
+        int32_t GetStartZ() const;
 
     private:
-        ChunksGrid grid_;
+        void SetChunk(int32_t chunk_x, int32_t chunk_z, std::shared_ptr<Chunk> chunk);
+        void SetStart(int32_t start_x, int32_t start_z);
+
+        bool IsInWindow(int32_t chunk_x, int32_t chunk_z) const;
+
+        static uint32_t GetSlot(int32_t chunk_coordinate);
+        static int32_t GetChunkCoordinate(int32_t coordinate);
     };
 }
 
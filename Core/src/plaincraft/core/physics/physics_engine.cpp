@@ -58,7 +58,7 @@ namespace plaincraft_core
     {
         for (auto &physic_object : dynamic_objects_)
         {
-            auto friction = physic_object->is_grounded ? physic_object->friction : physics_settings_.air_friction;
+            auto friction = physic_object->is_grounded ? physic_object->friction * physic_object->ground_friction : physics_settings_.air_friction;
             if (abs(time_step * physic_object->velocity.x * friction) < abs(physic_object->velocity.x))
             {
                 physic_object->velocity.x -= time_step * physic_object->velocity.x * friction;
@@ -97,12 +97,12 @@ namespace plaincraft_core
                     break;
                 }
 
-                auto compare = [](std::pair<float, Vector3d> &first, std::pair<float, Vector3d> &second)
+                auto compare = [](BlockCollision &first, BlockCollision &second)
                 {
-                    return first.first < second.first;
+                    return first.entry_time < second.entry_time;
                 };
 
-                auto [entry_time, normal] = *(std::min_element(potential_collisions.begin(), potential_collisions.end(), compare));
+                auto [entry_time, normal, block_id] = *(std::min_element(potential_collisions.begin(), potential_collisions.end(), compare));
                 entry_time -= 0.001;
 
                 if (normal.x)
@@ -118,6 +118,7 @@ namespace plaincraft_core
                     if(physic_object->velocity.y == 0.0f)
                     {
                         physic_object->is_grounded = true;
+                        physic_object->ground_friction = BlockRegistry::friction[block_id];
                     }
                 }
 
@@ -133,7 +134,7 @@ namespace plaincraft_core
         }
     }
 
-    std::vector<std::pair<float, Vector3d>> PhysicsEngine::FindPotentialCollisions(std::shared_ptr<PhysicsObject> &tested_object, Vector3d adjusted_velocity)
+    std::vector<PhysicsEngine::BlockCollision> PhysicsEngine::FindPotentialCollisions(std::shared_ptr<PhysicsObject> &tested_object, Vector3d adjusted_velocity)
     {
         auto blocks_to_test = FindBlocksToTestAABBCollision(tested_object, adjusted_velocity);
 
@@ -143,31 +144,28 @@ namespace plaincraft_core
         auto did_collide = false;
         float collision_time = 1.0f;
         Vector3d normals = Vector3d(0.0f, 0.0f, 0.0f);
-        std::vector<std::pair<float, Vector3d>> result;
+        std::vector<BlockCollision> result;
 
-        for (auto &block_to_test : blocks_to_test)
+        for (auto &[block_position, block_id] : blocks_to_test)
         {
-            auto [block_collision_time, block_normals] = TestAABBBlockCollision(tested_object, block_to_test);
+            auto [block_collision_time, block_normals] = TestAABBBlockCollision(tested_object, block_position, block_id);
 
             if (block_normals == Vector3d(0.0f, 0.0f, 0.f))
             {
                 continue;
             }
-            result.push_back(std::make_pair<float, Vector3d>(std::move(block_collision_time), std::move(block_normals)));
+            result.push_back({block_collision_time, block_normals, block_id});
         }
 
         return std::move(result);
     }
 
-    std::pair<float, Vector3d> PhysicsEngine::TestAABBBlockCollision(std::shared_ptr<PhysicsObject> &tested_object, const std::shared_ptr<Block> &block)
+    std::pair<float, Vector3d> PhysicsEngine::TestAABBBlockCollision(std::shared_ptr<PhysicsObject> &tested_object, const Vector3d &block_position, BlockId block_id)
     {
-        auto block_physics_object = block->GetPhysicsObject();
-
         auto tested_object_position = tested_object->position;
         auto tested_object_size = tested_object->size;
         auto tested_object_velocity = tested_object->velocity;
-        auto block_position = block_physics_object->position;
-        auto block_size = block_physics_object->size;
+        auto &collision_box = BlockRegistry::collision_boxes[block_id];
 
         auto tested_object_min_x = tested_object_position.x - tested_object_size.x / 2;
         auto tested_object_max_x = tested_object_position.x + tested_object_size.x / 2;
@@ -176,12 +174,12 @@ namespace plaincraft_core
         auto tested_object_min_z = tested_object_position.z - tested_object_size.z / 2;
         auto tested_object_max_z = tested_object_position.z + tested_object_size.z / 2;
 
-        auto block_min_x = block_position.x - block_size.x / 2;
-        auto block_max_x = block_position.x + block_size.x / 2;
-        auto block_min_y = block_position.y - block_size.y / 2;
-        auto block_max_y = block_position.y + block_size.y / 2;
-        auto block_min_z = block_position.z - block_size.z / 2;
-        auto block_max_z = block_position.z + block_size.z / 2;
+        auto block_min_x = block_position.x + collision_box.min_x;
+        auto block_max_x = block_position.x + collision_box.max_x;
+        auto block_min_y = block_position.y + collision_box.min_y;
+        auto block_max_y = block_position.y + collision_box.max_y;
+        auto block_min_z = block_position.z + collision_box.min_z;
+        auto block_max_z = block_position.z + collision_box.max_z;
 
         bool did_collide = false;
 
@@ -308,7 +306,7 @@ namespace plaincraft_core
         return std::make_pair<float, Vector3d>(std::move(entry_time), Vector3d(normal_x, normal_y, normal_z));
     }
 
-    std::set<std::shared_ptr<Block>> PhysicsEngine::FindBlocksToTestAABBCollision(std::shared_ptr<PhysicsObject> &tested_object, Vector3d predicted_move)
+    std::vector<std::pair<Vector3d, BlockId>> PhysicsEngine::FindBlocksToTestAABBCollision(std::shared_ptr<PhysicsObject> &tested_object, Vector3d predicted_move)
     {
         auto &size = tested_object->size;
         auto &position = tested_object->position;
@@ -316,11 +314,8 @@ namespace plaincraft_core
 
         auto block_size = Vector3d(1.0f, 1.0f, 1.0f);
 
-        auto result = std::set<std::shared_ptr<Block>>();
+        auto result = std::vector<std::pair<Vector3d, BlockId>>();
 
-        auto &grid = map_->GetGrid();
-        auto grid_x = grid[0][0]->GetPositionX();
-        auto grid_z = grid[0][0]->GetPositionZ();
 
         Vector3d broadPhaseBoxMin = Vector3d(
             predicted_move.x > 0 ? position.x : position.x + predicted_move.x,
@@ -344,8 +339,6 @@ namespace plaincraft_core
                 {
                     int32_t x_grid_alligned = x < 0 ? (x - chunk_size + 1) / chunk_size : x / chunk_size;
                     int32_t z_grid_alligned = z < 0 ? (z - chunk_size + 1) / chunk_size : z / chunk_size;
-                    auto chunk_x = x_grid_alligned - grid[0][0]->GetPositionX();
-                    auto chunk_z = z_grid_alligned - grid[0][0]->GetPositionZ();
 
                     auto block_x = (x % chunk_size + chunk_size) % chunk_size;
                     auto block_y = y % Chunk::chunk_height;
@@ -367,13 +360,21 @@ namespace plaincraft_core
                         continue;
                     }
 
-                    auto chunk = grid[chunk_x][chunk_z];
-                    auto& block_data = chunk->GetData();
+                    auto chunk = map_->GetChunk(x_grid_alligned, z_grid_alligned);
+                    if(chunk == nullptr || !chunk->initialized_)
+                    {
+                        continue;
+                    }
+
+                    if(chunk->GetSection(block_y / ChunkSection::section_size).IsEmpty())
+                    {
+                        continue;
+                    }
 
-                    auto block = block_data[block_x][block_y][block_z];
-                    if(block != nullptr)
+                    auto block_id = chunk->GetBlock(block_x, block_y, block_z);
+                    if(BlockRegistry::is_solid[block_id])
                     {
-                        result.insert(block);
+                        result.push_back(std::make_pair(block_position, block_id));
                     }
                 }
             }
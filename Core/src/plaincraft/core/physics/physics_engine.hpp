@@ -28,6 +28,7 @@ SOFTWARE.
 #define PLAINCRAFT_CORE_PHYSICS_ENGINE
 
 #include "../entities/map/map.hpp"
+#include "../entities/blocks/block_registry.hpp"
 #include "./physics_object.hpp"
 #include <functional>
 #include <list>
@@ -62,9 +63,16 @@ namespace plaincraft_core
         void Step(float time_step);
 
     private:
-        std::vector<std::pair<float, Vector3d>> FindPotentialCollisions(std::shared_ptr<PhysicsObject>& tested_object, Vector3d adjusted_velocity);
-        std::pair<float, Vector3d> TestAABBBlockCollision(std::shared_ptr<PhysicsObject>& tested_object, const std::shared_ptr<Block>& block);
-        std::set<std::shared_ptr<Block>> FindBlocksToTestAABBCollision(std::shared_ptr<PhysicsObject>& tested_object, Vector3d predicted_move);
+        struct BlockCollision
+        {
+            float entry_time;
+            Vector3d normal;
+            BlockId block_id;
+        };
+
+        std::vector<BlockCollision> FindPotentialCollisions(std::shared_ptr<PhysicsObject>& tested_object, Vector3d adjusted_velocity);
+        std::pair<float, Vector3d> TestAABBBlockCollision(std::shared_ptr<PhysicsObject>& tested_object, const Vector3d& block_position, BlockId block_id);
+        std::vector<std::pair<Vector3d, BlockId>> FindBlocksToTestAABBCollision(std::shared_ptr<PhysicsObject>& tested_object, Vector3d predicted_move);
     };
 }
 
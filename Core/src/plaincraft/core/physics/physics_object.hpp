@@ -50,6 +50,7 @@ namespace plaincraft_core
         bool is_grounded;
 
         float friction;
+        float ground_friction = 1.0f;
     };
 }
 
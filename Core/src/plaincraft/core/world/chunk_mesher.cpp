@@ -0,0 +1,584 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "./chunk_mesher.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+namespace plaincraft_core
+{
+    ChunkMesher::ChunkMesher(MeshingMode meshing_mode, MeshingBackend meshing_backend)
+        : meshing_mode_(meshing_mode), meshing_backend_(meshing_backend)
+    {
+    }
+
+    std::shared_ptr<ChunkMesh> ChunkMesher::MeshChunk(const Chunk &chunk, const ChunkNeighbors &neighbors, const CancellationToken &cancellation_token, Chunk::SectionsMask sections_mask, uint32_t lod_level)
+    {
+        auto scale = static_cast<uint32_t>(1) << std::min(lod_level, lod_levels_count - 1);
+
+        // The device meshes the chunk as a whole, edits replace its model like any other remesh
+        if (meshing_backend_ == MeshingBackend::Compute && scale == 1)
+        {
+            if (cancellation_token.IsCancelled())
+            {
+                return nullptr;
+            }
+
+            auto voxels = PackChunkVoxels(chunk, neighbors);
+            packed_voxels_bytes_ += voxels->GetBlocks().size() * sizeof(uint32_t);
+            meshed_chunks_count_ += 1;
+
+            return std::make_shared<ChunkMesh>(std::move(voxels));
+        }
+
+        std::vector<std::vector<ChunkVertex>> sections(Chunk::sections_count);
+        SectionBlocks blocks;
+        FaceCullingKernel::FaceMasks faces;
+
+        auto meshing_mode = meshing_mode_.load();
+
+        // Downsampled cells reach across sections, so a coarse mesh is always rebuilt as a whole
+        ChunkCells cells;
+        if (scale > 1)
+        {
+            sections_mask = Chunk::all_sections_mask;
+
+            std::shared_lock chunk_lock(chunk.blocks_mutex_);
+            DownsampleChunk(chunk, scale, cells);
+        }
+
+        for (uint32_t section_index = 0; section_index < Chunk::sections_count; ++section_index)
+        {
+            if (cancellation_token.IsCancelled())
+            {
+                return nullptr;
+            }
+
+            if (!(sections_mask & (static_cast<Chunk::SectionsMask>(1) << section_index)))
+            {
+                continue;
+            }
+
+            if (scale > 1)
+            {
+                CullDownsampledSection(cells, scale, section_index, blocks, faces);
+                if (meshing_mode == MeshingMode::Greedy)
+                {
+                    MeshSectionGreedy(blocks, faces, section_index, scale, sections[section_index]);
+                }
+                else
+                {
+                    MeshSectionNaive(blocks, faces, section_index, scale, sections[section_index]);
+                }
+                continue;
+            }
+
+            // Locked per section so that block edits wait for one section at most
+            std::shared_lock chunk_lock(chunk.blocks_mutex_);
+            std::shared_lock left_lock = LockBlocks(neighbors.left);
+            std::shared_lock right_lock = LockBlocks(neighbors.right);
+            std::shared_lock front_lock = LockBlocks(neighbors.front);
+            std::shared_lock back_lock = LockBlocks(neighbors.back);
+
+            if (chunk.GetSection(section_index).IsEmpty())
+            {
+                continue;
+            }
+
+            auto culling_start = std::chrono::steady_clock::now();
+            CullSection(chunk, neighbors, section_index, blocks, faces);
+            culling_nanoseconds_ += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - culling_start).count();
+            culled_voxels_count_ += ChunkSection::section_volume;
+
+            if (meshing_mode == MeshingMode::Greedy)
+            {
+                MeshSectionGreedy(blocks, faces, section_index, 1, sections[section_index]);
+            }
+            else
+            {
+                MeshSectionNaive(blocks, faces, section_index, 1, sections[section_index]);
+            }
+        }
+
+        auto mesh = std::make_shared<ChunkMesh>(std::move(sections), sections_mask);
+
+        meshed_chunks_count_ += 1;
+        meshed_vertices_count_ += mesh->GetVerticesCount();
+        meshed_indices_count_ += mesh->GetIndicesCount();
+
+        return mesh;
+    }
+
+    void ChunkMesher::SetMeshingMode(MeshingMode meshing_mode)
+    {
+        if (meshing_mode_.exchange(meshing_mode) != meshing_mode)
+        {
+            ResetStatistics();
+        }
+    }
+
+    MeshingMode ChunkMesher::GetMeshingMode() const
+    {
+        return meshing_mode_.load();
+    }
+
+    MeshingBackend ChunkMesher::GetMeshingBackend() const
+    {
+        return meshing_backend_;
+    }
+
+    MeshingStatistics ChunkMesher::GetStatistics() const
+    {
+        MeshingStatistics statistics;
+        statistics.chunks_count = meshed_chunks_count_.load();
+        statistics.vertices_count = meshed_vertices_count_.load();
+        statistics.indices_count = meshed_indices_count_.load();
+        statistics.upload_bytes = statistics.vertices_count * sizeof(ChunkVertex) + packed_voxels_bytes_.load();
+        statistics.culled_voxels_count = culled_voxels_count_.load();
+        statistics.culling_nanoseconds = culling_nanoseconds_.load();
+        return statistics;
+    }
+
+    void ChunkMesher::ResetStatistics()
+    {
+        meshed_chunks_count_ = 0;
+        meshed_vertices_count_ = 0;
+        meshed_indices_count_ = 0;
+        packed_voxels_bytes_ = 0;
+        culled_voxels_count_ = 0;
+        culling_nanoseconds_ = 0;
+    }
+
+    std::shared_lock<std::shared_mutex> ChunkMesher::LockBlocks(const std::shared_ptr<Chunk> &chunk)
+    {
+        return chunk != nullptr ? std::shared_lock(chunk->blocks_mutex_) : std::shared_lock<std::shared_mutex>();
+    }
+
+    std::shared_ptr<ChunkVoxels> ChunkMesher::PackChunkVoxels(const Chunk &chunk, const ChunkNeighbors &neighbors)
+    {
+        static_assert(Chunk::chunk_size == ChunkVoxels::size && Chunk::chunk_height == ChunkVoxels::height, "Chunk voxels expect the chunk dimensions");
+        constexpr uint32_t size = Chunk::chunk_size;
+
+        std::vector<uint32_t> blocks(ChunkVoxels::blocks_count / 2, 0);
+        auto set_block = [&blocks](uint32_t padded_x, uint32_t y, uint32_t padded_z, BlockId block_id)
+        {
+            auto index = ChunkVoxels::GetBlockIndex(padded_x, y, padded_z);
+            blocks[index / 2] |= static_cast<uint32_t>(block_id) << (index % 2 * 16);
+        };
+
+        std::shared_lock chunk_lock(chunk.blocks_mutex_);
+        std::shared_lock left_lock = LockBlocks(neighbors.left);
+        std::shared_lock right_lock = LockBlocks(neighbors.right);
+        std::shared_lock front_lock = LockBlocks(neighbors.front);
+        std::shared_lock back_lock = LockBlocks(neighbors.back);
+
+        for (uint32_t y = 0; y < Chunk::chunk_height; ++y)
+        {
+            for (uint32_t z = 0; z < size; ++z)
+            {
+                for (uint32_t x = 0; x < size; ++x)
+                {
+                    set_block(x + 1, y, z + 1, chunk.GetBlock(x, y, z));
+                }
+            }
+
+            // Borders with neighbors that are not generated yet hold air, like CullSection leaves them open
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                if (neighbors.left != nullptr)
+                {
+                    set_block(0, y, i + 1, neighbors.left->GetBlock(size - 1, y, i));
+                }
+                if (neighbors.right != nullptr)
+                {
+                    set_block(size + 1, y, i + 1, neighbors.right->GetBlock(0, y, i));
+                }
+                if (neighbors.front != nullptr)
+                {
+                    set_block(i + 1, y, 0, neighbors.front->GetBlock(i, y, size - 1));
+                }
+                if (neighbors.back != nullptr)
+                {
+                    set_block(i + 1, y, size + 1, neighbors.back->GetBlock(i, y, 0));
+                }
+            }
+        }
+
+        return std::make_shared<ChunkVoxels>(std::move(blocks), GetVoxelsBlockTable());
+    }
+
+    const std::vector<uint32_t> &ChunkMesher::GetVoxelsBlockTable()
+    {
+        static_assert(block_faces_count / 2 == ChunkVoxels::block_table_stride - 1, "Face tiles are packed two per word ahead of the flags");
+
+        static const std::vector<uint32_t> block_table = []()
+        {
+            std::vector<uint32_t> table(BlockRegistry::blocks_count * ChunkVoxels::block_table_stride, 0);
+            for (size_t block_id = 0; block_id < BlockRegistry::blocks_count; ++block_id)
+            {
+                auto entry = &table[block_id * ChunkVoxels::block_table_stride];
+                for (size_t face = 0; face < block_faces_count; ++face)
+                {
+                    auto &tile = BlockRegistry::face_textures[block_id][face];
+                    entry[face / 2] |= (static_cast<uint32_t>(tile.column) | (static_cast<uint32_t>(tile.row) << 8)) << (face % 2 * 16);
+                }
+                entry[ChunkVoxels::block_table_stride - 1] = BlockRegistry::is_opaque[block_id] ? ChunkVoxels::opaque_flag : 0;
+            }
+            return table;
+        }();
+
+        return block_table;
+    }
+
+    void ChunkMesher::CullSection(const Chunk &chunk, const ChunkNeighbors &neighbors, uint32_t section_index, SectionBlocks &blocks, FaceCullingKernel::FaceMasks &faces)
+    {
+        static_assert(Chunk::chunk_size == FaceCullingKernel::size && ChunkSection::section_size == FaceCullingKernel::size, "Face culling expects 16x16x16 sections");
+        constexpr uint32_t size = FaceCullingKernel::size;
+        constexpr uint32_t padded_size = FaceCullingKernel::padded_size;
+        constexpr uint32_t full_row = ((1u << size) - 1) << 1;
+
+        FaceCullingKernel::Occupancy occupancy;
+        occupancy.opaque.fill(0);
+
+        auto section_begin = section_index * ChunkSection::section_size;
+        auto &section = chunk.GetSection(section_index);
+
+        for (uint32_t y = 0; y < size; ++y)
+        {
+            for (uint32_t z = 0; z < size; ++z)
+            {
+                uint32_t solid_row = 0;
+                uint32_t opaque_row = 0;
+                for (uint32_t x = 0; x < size; ++x)
+                {
+                    auto block_id = section.GetBlock(x, y, z);
+                    blocks[(y * size + z) * size + x] = block_id;
+                    solid_row |= static_cast<uint32_t>(block_id != BlockIds::air) << x;
+                    opaque_row |= static_cast<uint32_t>(BlockRegistry::is_opaque[block_id]) << (x + 1);
+                }
+
+                occupancy.solid[y * size + z] = solid_row;
+                occupancy.opaque[(y + 1) * padded_size + z + 1] = opaque_row;
+            }
+        }
+
+        // Layers below and above the section come from the sections next to it, the world bottom and top stay closed
+        auto fill_layer = [&](uint32_t padded_y, int32_t chunk_y)
+        {
+            for (uint32_t z = 0; z < size; ++z)
+            {
+                uint32_t opaque_row = 0;
+                if (chunk_y < 0 || chunk_y >= static_cast<int32_t>(Chunk::chunk_height))
+                {
+                    opaque_row = full_row;
+                }
+                else
+                {
+                    for (uint32_t x = 0; x < size; ++x)
+                    {
+                        opaque_row |= static_cast<uint32_t>(BlockRegistry::is_opaque[chunk.GetBlock(x, chunk_y, z)]) << (x + 1);
+                    }
+                }
+                occupancy.opaque[padded_y * padded_size + z + 1] = opaque_row;
+            }
+        };
+        fill_layer(0, static_cast<int32_t>(section_begin) - 1);
+        fill_layer(padded_size - 1, static_cast<int32_t>(section_begin + size));
+
+        // Borders with neighbors that are not generated yet stay open, the chunk gets remeshed once they are
+        auto is_neighbor_opaque = [](const std::shared_ptr<Chunk> &neighbor, uint32_t x, uint32_t y, uint32_t z) -> uint32_t
+        {
+            return neighbor != nullptr && BlockRegistry::is_opaque[neighbor->GetBlock(x, y, z)];
+        };
+
+        for (uint32_t y = 0; y < size; ++y)
+        {
+            auto chunk_y = section_begin + y;
+            uint32_t front_row = 0;
+            uint32_t back_row = 0;
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                auto &row = occupancy.opaque[(y + 1) * padded_size + i + 1];
+                row |= is_neighbor_opaque(neighbors.left, size - 1, chunk_y, i);
+                row |= is_neighbor_opaque(neighbors.right, 0, chunk_y, i) << (size + 1);
+
+                front_row |= is_neighbor_opaque(neighbors.front, i, chunk_y, size - 1) << (i + 1);
+                back_row |= is_neighbor_opaque(neighbors.back, i, chunk_y, 0) << (i + 1);
+            }
+
+            occupancy.opaque[(y + 1) * padded_size] = front_row;
+            occupancy.opaque[(y + 1) * padded_size + padded_size - 1] = back_row;
+        }
+
+        FaceCullingKernel::CullFaces(occupancy, faces);
+    }
+
+    void ChunkMesher::DownsampleChunk(const Chunk &chunk, uint32_t scale, ChunkCells &cells)
+    {
+        auto cells_size = Chunk::chunk_size / scale;
+        auto cells_height = Chunk::chunk_height / scale;
+        cells.assign(cells_size * cells_size * cells_height, BlockIds::air);
+
+        // A cell is solid when any of its blocks is, so coarse terrain always encloses the detailed one and
+        // no holes open towards neighbors of another level. The topmost block keeps the surface material.
+        for (uint32_t cell_y = 0; cell_y < cells_height; ++cell_y)
+        {
+            for (uint32_t cell_z = 0; cell_z < cells_size; ++cell_z)
+            {
+                for (uint32_t cell_x = 0; cell_x < cells_size; ++cell_x)
+                {
+                    auto &cell = cells[(cell_y * cells_size + cell_z) * cells_size + cell_x];
+                    for (uint32_t y = (cell_y + 1) * scale; y-- > cell_y * scale && cell == BlockIds::air;)
+                    {
+                        for (uint32_t z = cell_z * scale; z < (cell_z + 1) * scale && cell == BlockIds::air; ++z)
+                        {
+                            for (uint32_t x = cell_x * scale; x < (cell_x + 1) * scale && cell == BlockIds::air; ++x)
+                            {
+                                cell = chunk.GetBlock(x, y, z);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void ChunkMesher::CullDownsampledSection(const ChunkCells &cells, uint32_t scale, uint32_t section_index, SectionBlocks &blocks, FaceCullingKernel::FaceMasks &faces)
+    {
+        constexpr uint32_t size = FaceCullingKernel::size;
+        constexpr uint32_t padded_size = FaceCullingKernel::padded_size;
+
+        auto cells_size = Chunk::chunk_size / scale;
+        auto cells_height = static_cast<int32_t>(Chunk::chunk_height / scale);
+        auto section_cells = ChunkSection::section_size / scale;
+        auto section_begin = static_cast<int32_t>(section_index * section_cells);
+        auto full_row = ((1u << cells_size) - 1) << 1;
+
+        // Cells fill the low corner of the kernel grid, the rest stays empty. Horizontal borders stay open as skirts.
+        FaceCullingKernel::Occupancy occupancy;
+        occupancy.solid.fill(0);
+        occupancy.opaque.fill(0);
+
+        for (int32_t y = -1; y <= static_cast<int32_t>(section_cells); ++y)
+        {
+            auto cell_y = section_begin + y;
+            for (uint32_t z = 0; z < cells_size; ++z)
+            {
+                uint32_t solid_row = 0;
+                uint32_t opaque_row = 0;
+                if (cell_y < 0 || cell_y >= cells_height)
+                {
+                    opaque_row = full_row;
+                }
+                else
+                {
+                    for (uint32_t x = 0; x < cells_size; ++x)
+                    {
+                        auto block_id = cells[(cell_y * cells_size + z) * cells_size + x];
+                        solid_row |= static_cast<uint32_t>(block_id != BlockIds::air) << x;
+                        opaque_row |= static_cast<uint32_t>(BlockRegistry::is_opaque[block_id]) << (x + 1);
+
+                        if (y >= 0 && y < static_cast<int32_t>(section_cells))
+                        {
+                            blocks[(y * size + z) * size + x] = block_id;
+                        }
+                    }
+                }
+
+                occupancy.opaque[(y + 1) * padded_size + z + 1] = opaque_row;
+                if (y >= 0 && y < static_cast<int32_t>(section_cells))
+                {
+                    occupancy.solid[y * size + z] = solid_row;
+                }
+            }
+        }
+
+        FaceCullingKernel::CullFaces(occupancy, faces);
+    }
+
+    void ChunkMesher::MeshSectionNaive(const SectionBlocks &blocks, const FaceCullingKernel::FaceMasks &faces, uint32_t section_index, uint32_t scale, std::vector<ChunkVertex> &vertices)
+    {
+        constexpr uint32_t size = FaceCullingKernel::size;
+        auto section_begin = section_index * ChunkSection::section_size;
+
+        for (uint8_t face = 0; face < block_faces_count; ++face)
+        {
+            auto block_face = static_cast<BlockFace>(face);
+
+            for (uint32_t row = 0; row < size * size; ++row)
+            {
+                auto y = row / size;
+                auto z = row % size;
+
+                for (auto visible = faces[face][row]; visible != 0; visible &= visible - 1)
+                {
+                    auto x = static_cast<uint32_t>(std::countr_zero(visible));
+                    auto block_id = blocks[row * size + x];
+                    AddQuad(vertices, block_face, x * scale, section_begin + y * scale, z * scale, scale, scale, scale, BlockRegistry::face_textures[block_id][face]);
+                }
+            }
+        }
+    }
+
+    void ChunkMesher::MeshSectionGreedy(const SectionBlocks &blocks, const FaceCullingKernel::FaceMasks &faces, uint32_t section_index, uint32_t scale, std::vector<ChunkVertex> &vertices)
+    {
+        constexpr int32_t plane_size = static_cast<int32_t>(FaceCullingKernel::size);
+
+        // Face tile of every visible face in the current slice, offset by one so zero marks no face
+        std::array<uint32_t, plane_size * plane_size> mask;
+
+        auto section_begin = static_cast<int32_t>(section_index * ChunkSection::section_size);
+
+        // Maps slice and in-plane coordinates onto the section axes used by AddQuad for the given face
+        auto to_block = [](BlockFace face, int32_t slice, int32_t u, int32_t v) -> std::array<int32_t, 3>
+        {
+            switch (face)
+            {
+            case BlockFace::Top:
+                return {u, slice, v};
+            case BlockFace::Bottom:
+                return {v, slice, u};
+            case BlockFace::Left:
+            case BlockFace::Right:
+                return {slice, v, u};
+            default:
+                return {u, v, slice};
+            }
+        };
+
+        for (uint8_t face = 0; face < block_faces_count; ++face)
+        {
+            auto block_face = static_cast<BlockFace>(face);
+
+            for (int32_t slice = 0; slice < plane_size; ++slice)
+            {
+                for (int32_t v = 0; v < plane_size; ++v)
+                {
+                    for (int32_t u = 0; u < plane_size; ++u)
+                    {
+                        auto [x, y, z] = to_block(block_face, slice, u, v);
+                        auto row = y * plane_size + z;
+                        auto &cell = mask[v * plane_size + u];
+                        cell = 0;
+
+                        if ((faces[face][row] >> x) & 1)
+                        {
+                            auto &tile = BlockRegistry::face_textures[blocks[row * plane_size + x]][face];
+                            cell = ((static_cast<uint32_t>(tile.column) << 8) | tile.row) + 1;
+                        }
+                    }
+                }
+
+                for (int32_t v = 0; v < plane_size; ++v)
+                {
+                    for (int32_t u = 0; u < plane_size;)
+                    {
+                        auto key = mask[v * plane_size + u];
+                        if (key == 0)
+                        {
+                            ++u;
+                            continue;
+                        }
+
+                        int32_t width = 1;
+                        while (u + width < plane_size && mask[v * plane_size + u + width] == key)
+                        {
+                            ++width;
+                        }
+
+                        int32_t height = 1;
+                        for (; v + height < plane_size; ++height)
+                        {
+                            auto row = &mask[(v + height) * plane_size + u];
+                            if (std::any_of(row, row + width, [key](uint32_t cell) { return cell != key; }))
+                            {
+                                break;
+                            }
+                        }
+
+                        for (int32_t row = v; row < v + height; ++row)
+                        {
+                            std::fill_n(&mask[row * plane_size + u], width, 0);
+                        }
+
+                        BlockTextureTile tile{static_cast<uint8_t>((key - 1) >> 8), static_cast<uint8_t>((key - 1) & 0xff)};
+                        auto [x, y, z] = to_block(block_face, slice, u, v);
+                        AddQuad(vertices, block_face, x * scale, section_begin + y * scale, z * scale, width * scale, height * scale, scale, tile);
+
+                        u += width;
+                    }
+                }
+            }
+        }
+    }
+
+    void ChunkMesher::AddQuad(std::vector<ChunkVertex> &vertices, BlockFace face, uint32_t x, uint32_t y, uint32_t z, uint32_t width, uint32_t height, uint32_t depth, BlockTextureTile tile)
+    {
+        auto w = width;
+        auto h = height;
+        auto d = depth;
+
+        std::array<std::array<uint32_t, 3>, 4> corners;
+        std::array<std::array<uint32_t, 2>, 4> texture_coordinates;
+
+        // Corners are counted from the block minimum, texture coordinates in blocks so the chunk shader can repeat the tile
+        switch (face)
+        {
+        case BlockFace::Top:
+            corners = {{{x, y + d, z}, {x + w, y + d, z}, {x + w, y + d, z + h}, {x, y + d, z + h}}};
+            texture_coordinates = {{{0, 0}, {w, 0}, {w, h}, {0, h}}};
+            break;
+        case BlockFace::Bottom:
+            corners = {{{x, y, z}, {x, y, z + w}, {x + h, y, z + w}, {x + h, y, z}}};
+            texture_coordinates = {{{0, 0}, {w, 0}, {w, h}, {0, h}}};
+            break;
+        case BlockFace::Left:
+            corners = {{{x, y, z}, {x, y + h, z}, {x, y + h, z + w}, {x, y, z + w}}};
+            texture_coordinates = {{{0, h}, {0, 0}, {w, 0}, {w, h}}};
+            break;
+        case BlockFace::Right:
+            corners = {{{x + d, y, z}, {x + d, y, z + w}, {x + d, y + h, z + w}, {x + d, y + h, z}}};
+            texture_coordinates = {{{0, h}, {w, h}, {w, 0}, {0, 0}}};
+            break;
+        case BlockFace::Front:
+            corners = {{{x, y, z}, {x + w, y, z}, {x + w, y + h, z}, {x, y + h, z}}};
+            texture_coordinates = {{{0, h}, {w, h}, {w, 0}, {0, 0}}};
+            break;
+        case BlockFace::Back:
+            corners = {{{x, y, z + d}, {x, y + h, z + d}, {x + w, y + h, z + d}, {x + w, y, z + d}}};
+            texture_coordinates = {{{0, h}, {0, 0}, {w, 0}, {w, h}}};
+            break;
+        }
+
+        for (size_t i = 0; i < corners.size(); ++i)
+        {
+            auto &[corner_x, corner_y, corner_z] = corners[i];
+            auto &[u, v] = texture_coordinates[i];
+            vertices.push_back(ChunkVertex::Pack(corner_x, corner_y, corner_z, face, u, v, tile.column, tile.row));
+        }
+    }
+}
@@ -0,0 +1,132 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_CORE_CHUNK_MESHER
+#define PLAINCRAFT_CORE_CHUNK_MESHER
+
+#include "../entities/map/chunk.hpp"
+#include "../entities/blocks/block_registry.hpp"
+#include "face_culling_kernel.hpp"
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+#include <plaincraft_common.hpp>
+#include <plaincraft_render_engine.hpp>
+
+namespace plaincraft_core
+{
+    using namespace plaincraft_render_engine;
+
+    enum class MeshingMode
+    {
+        Naive,
+        Greedy
+    };
+
+    // Compute leaves the faces of full detail chunks to the device and only packs their voxels, coarser levels stay on the CPU
+    enum class MeshingBackend
+    {
+        Cpu,
+        Compute
+    };
+
+    struct MeshingStatistics
+    {
+        uint64_t chunks_count;
+        uint64_t vertices_count;
+        uint64_t indices_count;
+        uint64_t upload_bytes;
+        uint64_t culled_voxels_count;
+        uint64_t culling_nanoseconds;
+    };
+
+    // Horizontal neighbors of a chunk being meshed, null while not generated
+    struct ChunkNeighbors
+    {
+        std::shared_ptr<Chunk> left;
+        std::shared_ptr<Chunk> right;
+        std::shared_ptr<Chunk> front;
+        std::shared_ptr<Chunk> back;
+    };
+
+    // Builds chunk meshes out of blocks alone, without the map, the assets or the device
+    class ChunkMesher
+    {
+    public:
+        static constexpr uint32_t lod_levels_count = 4;
+
+    private:
+        std::atomic<MeshingMode> meshing_mode_;
+        const MeshingBackend meshing_backend_;
+        std::atomic<uint64_t> meshed_chunks_count_ = 0;
+        std::atomic<uint64_t> meshed_vertices_count_ = 0;
+        std::atomic<uint64_t> meshed_indices_count_ = 0;
+        std::atomic<uint64_t> packed_voxels_bytes_ = 0;
+        std::atomic<uint64_t> culled_voxels_count_ = 0;
+        std::atomic<uint64_t> culling_nanoseconds_ = 0;
+
+    public:
+        ChunkMesher(MeshingMode meshing_mode = MeshingMode::Greedy, MeshingBackend meshing_backend = MeshingBackend::Cpu);
+
+        ChunkMesher(const ChunkMesher &other) = delete;
+        ChunkMesher &operator=(const ChunkMesher &other) = delete;
+
+        // Safe to run on any thread, the chunk and its neighbors are locked for reading while their blocks are read.
+        // Sections left out of the mask keep their geometry from the current model of the chunk.
+        // Level of detail above zero meshes 2^level downsampled cells with open borders that skirt the seams to other levels.
+        std::shared_ptr<ChunkMesh> MeshChunk(const Chunk &chunk, const ChunkNeighbors &neighbors, const CancellationToken &cancellation_token = CancellationToken(), Chunk::SectionsMask sections_mask = Chunk::all_sections_mask, uint32_t lod_level = 0);
+
+        void SetMeshingMode(MeshingMode meshing_mode);
+        MeshingMode GetMeshingMode() const;
+        MeshingBackend GetMeshingBackend() const;
+
+        MeshingStatistics GetStatistics() const;
+        void ResetStatistics();
+
+    private:
+        static std::shared_lock<std::shared_mutex> LockBlocks(const std::shared_ptr<Chunk> &chunk);
+
+        // Blocks of one section decoded out of the palette, blocks[(y * size + z) * size + x]
+        using SectionBlocks = std::array<BlockId, FaceCullingKernel::size * FaceCullingKernel::size * FaceCullingKernel::size>;
+
+        // Downsampled cells of a whole chunk, cells[(y * cells_size + z) * cells_size + x] with cells_size = chunk_size / scale
+        using ChunkCells = std::vector<BlockId>;
+
+        static std::shared_ptr<ChunkVoxels> PackChunkVoxels(const Chunk &chunk, const ChunkNeighbors &neighbors);
+        static const std::vector<uint32_t> &GetVoxelsBlockTable();
+
+        static void CullSection(const Chunk &chunk, const ChunkNeighbors &neighbors, uint32_t section_index, SectionBlocks &blocks, FaceCullingKernel::FaceMasks &faces);
+        static void DownsampleChunk(const Chunk &chunk, uint32_t scale, ChunkCells &cells);
+        static void CullDownsampledSection(const ChunkCells &cells, uint32_t scale, uint32_t section_index, SectionBlocks &blocks, FaceCullingKernel::FaceMasks &faces);
+        static void MeshSectionNaive(const SectionBlocks &blocks, const FaceCullingKernel::FaceMasks &faces, uint32_t section_index, uint32_t scale, std::vector<ChunkVertex> &vertices);
+        static void MeshSectionGreedy(const SectionBlocks &blocks, const FaceCullingKernel::FaceMasks &faces, uint32_t section_index, uint32_t scale, std::vector<ChunkVertex> &vertices);
+
+        static void AddQuad(std::vector<ChunkVertex> &vertices, BlockFace face, uint32_t x, uint32_t y, uint32_t z, uint32_t width, uint32_t height, uint32_t depth, BlockTextureTile tile);
+    };
+}
+
+#endif // PLAINCRAFT_CORE_CHUNK_MESHER
@@ -26,10 +26,10 @@ SOFTWARE.
 
 #include "chunk_builder.hpp"
 #include "../../utils/conversions.hpp"
-#include "../../entities/blocks/dirt.hpp"
-#include "../../entities/blocks/stone.hpp"
+#include "../../entities/blocks/block_id.hpp"
 #include <plaincraft_common.hpp>
 #include <plaincraft_render_engine.hpp>
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <random>
@@ -40,15 +40,61 @@ namespace plaincraft_core
 							   uint64_t seed)
 		: scene_(scene),
 		  seed_(seed),
-		  perlin_(seed)
+		  perlin_(seed),
+		  noise_kernel_(perlin_.serialize())
 	{
-		perlin_.reseed(seed);
 	}
 
 	ChunkBuilder::~ChunkBuilder()
 	{
 	}
 
+	bool ChunkBuilder::GenerateChunk(std::shared_ptr<Chunk> chunk, const CancellationToken &cancellation_token)
+	{
+		HeightMap height_map;
+		FillHeightMap(*chunk, height_map);
+		auto [min_height, max_height] = std::minmax_element(height_map.begin(), height_map.end());
+
+		auto &sections = chunk->GetData();
+		for (uint32_t section_index = 0; section_index < Chunk::sections_count; ++section_index)
+		{
+			if (cancellation_token.IsCancelled())
+			{
+				return false;
+			}
+
+			auto &section = sections[section_index];
+			auto section_begin = section_index * ChunkSection::section_size;
+			auto section_end = section_begin + ChunkSection::section_size;
+
+			if (section_begin > *max_height)
+			{
+				continue;
+			}
+
+			if (section_end - 1 <= *min_height)
+			{
+				section.Fill(BlockIds::stone);
+				continue;
+			}
+
+			for (uint32_t k = 0; k < Chunk::chunk_size; ++k)
+			{
+				for (uint32_t i = 0; i < Chunk::chunk_size; ++i)
+				{
+					auto column_end = std::min(height_map[k * Chunk::chunk_size + i] + 1, section_end);
+					for (auto j = section_begin; j < column_end; ++j)
+					{
+						section.SetBlock(i, j - section_begin, k, BlockIds::stone);
+					}
+				}
+			}
+		}
+
+		chunk->initialized_ = true;
+		return true;
+	}
+
 	bool ChunkBuilder::GenerateChunkStep(std::shared_ptr<Chunk> chunk)
 	{
 		// static auto cube_shape = physics_common_.createBoxShape(rp3d::Vector3(0.5, 0.5, 0.5));
@@ -58,23 +104,12 @@ namespace plaincraft_core
 		auto &[i, j, k] = chunk_processing_data;
 
 		auto x = static_cast<int32_t>(Chunk::chunk_size) * chunk->GetPositionX() + i * 1.0;
-		auto y = static_cast<int32_t>(Chunk::chunk_size) * 0 + j * 1.0;
 		auto z = static_cast<int32_t>(Chunk::chunk_size) * chunk->GetPositionZ() + k * 1.0;
-		auto noise = perlin_.normalizedOctave2D_01(x / 256, z / 256, 4);
-
-		const uint32_t height = static_cast<uint32_t>(Chunk::chunk_height * noise);
+		const uint32_t height = GetHeight(x, z);
 
 		if (j <= height)
 		{
-			std::shared_ptr<Block> game_object;
-			game_object = std::make_shared<Stone>();
-			auto physics_object = std::make_shared<PhysicsObject>();
-			physics_object->size = Vector3d(1.0f, 1.0f, 1.0f);
-			physics_object->position = Vector3d(x, y, z);
-			physics_object->type = PhysicsObject::ObjectType::Static;
-			game_object->SetPhysicsObject(physics_object);
-			// game_object->SetObjectType(GameObject::ObjectType::Static);
-			chunk->blocks_[i][j][k] = game_object;
+			chunk->SetBlock(i, j, k, BlockIds::stone);
 		}
 
 		auto result = Increment(chunk_processing_data);
@@ -102,23 +137,6 @@ namespace plaincraft_core
 			scene_->RemoveGameObject(chunk);
 		}
 
-		auto &blocks = chunk->GetData();
-		if (blocks.empty())
-		{
-			DisposeProcessingData(chunk_disposal_datas_, chunk);
-			return true;
-		}
-
-		auto &block = blocks[i][j][k];
-		if (block != nullptr)
-		{
-			//scene_.RemoveGameObject(block);
-			// if(block->GetRigidBody())
-			// {
-			// 	physics_world_->destroyRigidBody(block->GetRigidBody());
-			// }
-		}
-
 		auto result = Increment(chunk_processing_data);
 		if (result)
 		{
@@ -129,6 +147,34 @@ namespace plaincraft_core
 		return result;
 	}
 
+	void ChunkBuilder::CancelChunk(std::shared_ptr<Chunk> chunk)
+	{
+		std::lock_guard lg(chunk_creation_datas_mutex_);
+		DisposeProcessingData(chunk_creation_datas_, chunk);
+	}
+
+	uint32_t ChunkBuilder::GetHeight(double x, double z) const
+	{
+		auto noise = perlin_.normalizedOctave2D_01(x / 256, z / 256, 4);
+		return static_cast<uint32_t>(Chunk::chunk_height * noise);
+	}
+
+	void ChunkBuilder::FillHeightMap(const Chunk &chunk, HeightMap &height_map) const
+	{
+		static_assert(PerlinNoiseKernel::grid_size == Chunk::chunk_size);
+
+		auto chunk_x = static_cast<int32_t>(Chunk::chunk_size) * chunk.GetPositionX();
+		auto chunk_z = static_cast<int32_t>(Chunk::chunk_size) * chunk.GetPositionZ();
+
+		PerlinNoiseKernel::Grid noise;
+		noise_kernel_.NormalizedOctave2D01(chunk_x, chunk_z, 256, 4, 0.5, noise);
+
+		for (size_t i = 0; i < noise.size(); ++i)
+		{
+			height_map[i] = static_cast<uint32_t>(Chunk::chunk_height * noise[i]);
+		}
+	}
+
 	ChunkBuilder::ChunkProcessingData &ChunkBuilder::GetProcessingData(std::unordered_map<std::shared_ptr<Chunk>, ChunkBuilder::ChunkProcessingData> &collection, std::shared_ptr<Chunk> chunk)
 	{
 		if (!collection.contains(chunk))
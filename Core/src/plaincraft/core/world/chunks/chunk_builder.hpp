@@ -31,6 +31,7 @@ SOFTWARE.
 #include "../../common.hpp"
 #include "../../scene/scene.hpp"
 #include <lib/PerlinNoise.hpp>
+#include <array>
 #include <stack>
 #include <unordered_map>
 #include <mutex>
@@ -45,8 +46,11 @@ namespace plaincraft_core
 			size_t i, j, k;
 		};
 
+		using HeightMap = std::array<uint32_t, Chunk::chunk_size * Chunk::chunk_size>;
+
 		uint64_t seed_;
 		siv::PerlinNoise perlin_;
+		PerlinNoiseKernel noise_kernel_;
 
 	public:
 		std::shared_ptr<Scene> scene_;
@@ -60,10 +64,15 @@ namespace plaincraft_core
 		ChunkBuilder(std::shared_ptr<Scene> scene, uint64_t seed);
 		virtual ~ChunkBuilder();
 
+		bool GenerateChunk(std::shared_ptr<Chunk> chunk, const CancellationToken &cancellation_token) override;
 		bool GenerateChunkStep(std::shared_ptr<Chunk> chunk) override;
+		void CancelChunk(std::shared_ptr<Chunk> chunk) override;
 		bool DisposeChunkStep(std::shared_ptr<Chunk> chunk) override;
 
 	private:
+		uint32_t GetHeight(double x, double z) const;
+		void FillHeightMap(const Chunk &chunk, HeightMap &height_map) const;
+
 		ChunkProcessingData &GetProcessingData(std::unordered_map<std::shared_ptr<Chunk>, ChunkProcessingData> &collection, std::shared_ptr<Chunk> chunk);
 		void DisposeProcessingData(std::unordered_map<std::shared_ptr<Chunk>, ChunkProcessingData> &collection, std::shared_ptr<Chunk> chunk);
 		bool Increment(ChunkProcessingData &chunk_processing_data);
@@ -40,4 +40,22 @@ namespace plaincraft_core
         chunk->SetDrawable(drawable);
         return chunk;
     }
+
+    bool ChunkBuilderBase::GenerateChunk(std::shared_ptr<Chunk> chunk, const CancellationToken &cancellation_token)
+    {
+        while (!GenerateChunkStep(chunk))
+        {
+            if (cancellation_token.IsCancelled())
+            {
+                CancelChunk(chunk);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void ChunkBuilderBase::CancelChunk(std::shared_ptr<Chunk>)
+    {
+    }
 }
\ No newline at end of file
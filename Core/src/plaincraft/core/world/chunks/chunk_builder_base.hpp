@@ -38,7 +38,9 @@ namespace plaincraft_core
             virtual ~ChunkBuilderBase();
 
             virtual std::shared_ptr<Chunk> InitializeChunk(int32_t position_x, int32_t position_z);
+            virtual bool GenerateChunk(std::shared_ptr<Chunk> chunk, const CancellationToken &cancellation_token = CancellationToken());
             virtual bool GenerateChunkStep(std::shared_ptr<Chunk> chunk) = 0;
+            virtual void CancelChunk(std::shared_ptr<Chunk> chunk);
             virtual bool DisposeChunkStep(std::shared_ptr<Chunk> chunk) = 0;
     };
 }
@@ -0,0 +1,117 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "./chunks_priority_queue.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace plaincraft_core
+{
+    void ChunksPriorityQueue::Push(std::shared_ptr<Chunk> chunk)
+    {
+        auto bucket_index = GetBucketIndex(*chunk);
+        if (bucket_index >= buckets_.size())
+        {
+            buckets_.resize(bucket_index + 1);
+        }
+
+        buckets_[bucket_index].push_back(std::move(chunk));
+        lowest_bucket_ = std::min(lowest_bucket_, bucket_index);
+        ++size_;
+    }
+
+    std::shared_ptr<Chunk> ChunksPriorityQueue::Pop()
+    {
+        if (size_ == 0)
+        {
+            return nullptr;
+        }
+
+        if (is_rekey_required_)
+        {
+            Rekey();
+        }
+
+        while (buckets_[lowest_bucket_].empty())
+        {
+            ++lowest_bucket_;
+        }
+
+        auto &bucket = buckets_[lowest_bucket_];
+        auto result = std::move(bucket.back());
+        bucket.pop_back();
+        --size_;
+
+        return result;
+    }
+
+    void ChunksPriorityQueue::SetOrigin(int32_t chunk_x, int32_t chunk_z)
+    {
+        if (chunk_x == origin_x_ && chunk_z == origin_z_)
+        {
+            return;
+        }
+
+        origin_x_ = chunk_x;
+        origin_z_ = chunk_z;
+        is_rekey_required_ = true;
+    }
+
+    bool ChunksPriorityQueue::IsEmpty() const
+    {
+        return size_ == 0;
+    }
+
+    size_t ChunksPriorityQueue::GetSize() const
+    {
+        return size_;
+    }
+
+    size_t ChunksPriorityQueue::GetBucketIndex(const Chunk &chunk) const
+    {
+        auto distance_x = std::abs(chunk.GetPositionX() - origin_x_);
+        auto distance_z = std::abs(chunk.GetPositionZ() - origin_z_);
+        return static_cast<size_t>(std::max(distance_x, distance_z));
+    }
+
+    void ChunksPriorityQueue::Rekey()
+    {
+        is_rekey_required_ = false;
+
+        std::vector<Bucket> buckets;
+        buckets.swap(buckets_);
+        lowest_bucket_ = buckets.size();
+        size_ = 0;
+
+        for (auto &bucket : buckets)
+        {
+            for (auto &chunk : bucket)
+            {
+                Push(std::move(chunk));
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_CORE_CHUNKS_PRIORITY_QUEUE
+#define PLAINCRAFT_CORE_CHUNKS_PRIORITY_QUEUE
+
+#include "../../entities/map/chunk.hpp"
+#include <memory>
+#include <vector>
+
+namespace plaincraft_core
+{
+    // Chunks bucketed by their ring (Chebyshev) distance to the origin chunk.
+    // Moving the origin only marks the queue as stale, buckets are rebuilt on the next pop.
+    class ChunksPriorityQueue
+    {
+    private:
+        using Bucket = std::vector<std::shared_ptr<Chunk>>;
+
+        std::vector<Bucket> buckets_;
+        size_t lowest_bucket_ = 0;
+        size_t size_ = 0;
+
+        int32_t origin_x_ = 0;
+        int32_t origin_z_ = 0;
+        bool is_rekey_required_ = false;
+
+    public:
+        void Push(std::shared_ptr<Chunk> chunk);
+        std::shared_ptr<Chunk> Pop();
+
+        void SetOrigin(int32_t chunk_x, int32_t chunk_z);
+
+        bool IsEmpty() const;
+        size_t GetSize() const;
+
+    private:
+        size_t GetBucketIndex(const Chunk &chunk) const;
+        void Rekey();
+    };
+}
+
+#endif // PLAINCRAFT_CORE_CHUNKS_PRIORITY_QUEUE
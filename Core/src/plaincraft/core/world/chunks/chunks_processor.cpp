@@ -26,6 +26,8 @@ SOFTWARE.
 
 #include "./chunks_processor.hpp"
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 
 namespace plaincraft_core
 {
@@ -61,33 +63,61 @@ namespace plaincraft_core
         return *this;
     }
 
-    bool ChunksProcessor::Metric::Compare(const std::shared_ptr<Chunk> &first, const std::shared_ptr<Chunk> &second)
+    std::pair<int32_t, int32_t> ChunksProcessor::Metric::GetOriginChunkPosition() const
     {
-        auto position = origin_->GetPhysicsObject()->position;
-        auto first_position_x = first->GetPositionX() * static_cast<float>(Chunk::chunk_size);
-        auto first_position_z = first->GetPositionZ() * static_cast<float>(Chunk::chunk_size);
-        auto second_position_x = second->GetPositionX() * static_cast<float>(Chunk::chunk_size);
-        auto second_position_z = second->GetPositionZ() * static_cast<float>(Chunk::chunk_size);
-
-        auto first_distance_to_player_squared = (first_position_x - position.x) * (first_position_x - position.x) + (first_position_z - position.z) * (first_position_z - position.z);
-        auto second_distance_to_player_squared = (second_position_x - position.x) * (second_position_x - position.x) + (second_position_z - position.z) * (second_position_z - position.z);
-        return first_distance_to_player_squared > second_distance_to_player_squared;
+        auto position = origin_->GetPhysicsObject()->position / static_cast<float>(Chunk::chunk_size);
+        return std::make_pair(static_cast<int32_t>(std::floor(position.x)), static_cast<int32_t>(std::floor(position.z)));
     }
 
     ChunksProcessor::ChunksProcessor(
         std::unique_ptr<ChunkBuilderBase> chunk_builder,
         std::unique_ptr<WorldOptimizer> world_optimizer,
         std::shared_ptr<Scene> scene,
-        Metric metric)
+        Metric metric,
+        ChunksPipelineConfig config)
         : chunk_builder_(std::move(chunk_builder)),
           world_optimizer_(std::move(world_optimizer)),
           scene_(scene),
           metric_(metric),
-          creator_thread_([this]
-                          { this->CreatorCallback(); }),
-          disposal_thread_([this]
-                           { this->DisposalCallback(); })
+          upload_queue_capacity_(std::max<size_t>(config.upload_queue_capacity, 1)),
+          lod_distances_(config.lod_distances)
     {
+        // Generation and meshing split the default workers evenly unless configured otherwise
+        auto default_workers_count = GetDefaultWorkersCount();
+        if (config.generation_workers_count == 0)
+        {
+            config.generation_workers_count = std::max<uint32_t>(default_workers_count / 2, 1);
+        }
+
+        if (config.meshing_workers_count == 0)
+        {
+            config.meshing_workers_count = std::max<uint32_t>(default_workers_count - std::min(default_workers_count, config.generation_workers_count), 1);
+        }
+
+        config.upload_workers_count = std::max<uint32_t>(config.upload_workers_count, 1);
+
+        for (uint32_t i = 0; i < config.generation_workers_count; ++i)
+        {
+            workers_.emplace_back(std::make_unique<Worker>());
+        }
+
+        for (auto &worker : workers_)
+        {
+            worker->thread = std::thread([this, &worker = *worker]
+                                         { this->WorkerCallback(worker); });
+        }
+
+        for (uint32_t i = 0; i < config.meshing_workers_count; ++i)
+        {
+            meshing_threads_.emplace_back([this]
+                                          { this->MeshingWorkerCallback(); });
+        }
+
+        for (uint32_t i = 0; i < config.upload_workers_count; ++i)
+        {
+            upload_threads_.emplace_back([this]
+                                         { this->UploadWorkerCallback(); });
+        }
     }
 
     ChunksProcessor::ChunksProcessor(ChunksProcessor &&other) noexcept
@@ -95,12 +125,18 @@ namespace plaincraft_core
           chunk_builder_(std::move(other.chunk_builder_)),
           world_optimizer_(std::move(other.world_optimizer_)),
           scene_(std::move(other.scene_)),
+          chunks_index_(std::move(other.chunks_index_)),
           requested_chunks_(std::move(other.requested_chunks_)),
+          meshing_chunks_(std::move(other.meshing_chunks_)),
+          uploading_chunks_(std::move(other.uploading_chunks_)),
           rejected_chunks_(std::move(other.rejected_chunks_)),
-          current_to_create_(std::move(other.current_to_create_)),
-          current_to_dispose_(std::move(other.current_to_dispose_)),
-          creator_thread_(std::move(other.creator_thread_)),
-          disposal_thread_(std::move(other.disposal_thread_))
+          workers_(std::move(other.workers_)),
+          meshing_threads_(std::move(other.meshing_threads_)),
+          upload_threads_(std::move(other.upload_threads_)),
+          upload_queue_capacity_(other.upload_queue_capacity_),
+          upload_slots_count_(other.upload_slots_count_),
+          lod_distances_(other.lod_distances_),
+          lod_origin_(other.lod_origin_)
     {
     }
 
@@ -115,12 +151,18 @@ namespace plaincraft_core
         this->world_optimizer_ = std::move(other.world_optimizer_);
         this->scene_ = std::move(other.scene_);
         this->metric_ = std::move(other.metric_);
+        this->chunks_index_ = std::move(other.chunks_index_);
         this->requested_chunks_ = std::move(other.requested_chunks_);
+        this->meshing_chunks_ = std::move(other.meshing_chunks_);
+        this->uploading_chunks_ = std::move(other.uploading_chunks_);
         this->rejected_chunks_ = std::move(other.rejected_chunks_);
-        this->current_to_create_ = std::move(other.current_to_create_);
-        this->current_to_dispose_ = std::move(other.current_to_dispose_);
-        this->creator_thread_ = std::move(other.creator_thread_);
-        this->disposal_thread_ = std::move(other.disposal_thread_);
+        this->workers_ = std::move(other.workers_);
+        this->meshing_threads_ = std::move(other.meshing_threads_);
+        this->upload_threads_ = std::move(other.upload_threads_);
+        this->upload_queue_capacity_ = other.upload_queue_capacity_;
+        this->upload_slots_count_ = other.upload_slots_count_;
+        this->lod_distances_ = other.lod_distances_;
+        this->lod_origin_ = other.lod_origin_;
 
         return *this;
     }
@@ -128,160 +170,761 @@ namespace plaincraft_core
     ChunksProcessor::~ChunksProcessor()
     {
         stop_ = true;
-        
-        any_requested_.notify_one();
-        any_rejected_.notify_one();
+        NotifyWorkers();
 
-        creator_thread_.join();
-        disposal_thread_.join();
+        for (auto &worker : workers_)
+        {
+            worker->thread.join();
+        }
+
+        for (auto &thread : meshing_threads_)
+        {
+            thread.join();
+        }
+
+        for (auto &thread : upload_threads_)
+        {
+            thread.join();
+        }
     }
 
     std::shared_ptr<Chunk> ChunksProcessor::RequestChunk(int32_t chunk_x, int32_t chunk_z)
     {
-        std::list<std::shared_ptr<Chunk>>::iterator chunk_iterator;
-        std::shared_ptr<Chunk> result;
+        std::unique_lock lk(chunks_mutex_);
+        auto [entry_iterator, is_inserted] = chunks_index_.try_emplace(GetChunkKey(chunk_x, chunk_z));
+        auto &entry = entry_iterator->second;
+
+        if (!is_inserted)
+        {
+            // Chunk waiting to be rejected is no longer to be rejected
+            if (entry.state == ChunkState::Rejected)
+            {
+                entry.state = entry.is_meshed ? ChunkState::Ready : ChunkState::Generating;
+
+                // Meshing dropped from the queue while rejected is picked up again
+                if (entry.is_mesh_pending && !entry.is_meshing)
+                {
+                    meshing_chunks_.push_back(entry.chunk);
+                    auto result = entry.chunk;
+                    lk.unlock();
+                    NotifyWorkers();
+                    return result;
+                }
+            }
+
+            return entry.chunk;
+        }
+
+        entry.chunk = chunk_builder_->InitializeChunk(chunk_x, chunk_z);
+        entry.state = ChunkState::Requested;
+        requested_chunks_.Push(entry.chunk);
+        auto result = entry.chunk;
+
+        lk.unlock();
+        NotifyWorkers();
+        return result;
+    }
+
+    void ChunksProcessor::RejectChunk(std::shared_ptr<Chunk> chunk)
+    {
+        std::unique_lock lk(chunks_mutex_);
+        auto entry_iterator = chunks_index_.find(GetChunkKey(chunk->pos_x_, chunk->pos_z_));
+        if (entry_iterator == chunks_index_.end() || entry_iterator->second.chunk != chunk)
+        {
+            return;
+        }
 
-        auto find_chunk_predicate = [chunk_x, chunk_z](const std::shared_ptr<Chunk> &chunk)
+        auto &entry = entry_iterator->second;
+        bool is_scheduled = false;
+        switch (entry.state)
         {
-            return chunk->pos_x_ == chunk_x && chunk->pos_z_ == chunk_z;
-        };
+        case ChunkState::Requested:
+            // Never picked up, queues drop it lazily
+            chunks_index_.erase(entry_iterator);
+            is_scheduled = ScheduleNeighborsMeshing(chunk->pos_x_, chunk->pos_z_, false);
+            break;
+        case ChunkState::Generating:
+            if (!entry.is_generated || entry.is_meshing)
+            {
+                // The worker stops at its next cancellation check and drops the chunk
+                entry.state = ChunkState::Rejected;
+                entry.cancellation_token.Cancel();
+            }
+            else
+            {
+                // Generated but waiting for its first mesh, there is no job to stop
+                chunks_index_.erase(entry_iterator);
+                is_scheduled = ScheduleNeighborsMeshing(chunk->pos_x_, chunk->pos_z_, false);
+            }
+            break;
+        case ChunkState::Ready:
+            entry.state = ChunkState::Rejected;
+            entry.cancellation_token.Cancel();
+            rejected_chunks_.push_back(chunk);
+            is_scheduled = true;
+            break;
+        case ChunkState::Rejected:
+            break;
+        }
 
-        // Check if chunk is already created
-        if (current_to_create_ != nullptr && current_to_create_->pos_x_ == chunk_x && current_to_create_->pos_z_ == chunk_z)
+        if (is_scheduled)
         {
-            return current_to_create_;
+            lk.unlock();
+            NotifyWorkers();
         }
+    }
 
-        // Check if chunk is waiting to be processed
-        std::unique_lock lk_requested(requested_chunks_mutex_);
-        chunk_iterator = std::find_if(requested_chunks_.begin(), requested_chunks_.end(), find_chunk_predicate);
+    void ChunksProcessor::RemeshChunk(std::shared_ptr<Chunk> chunk)
+    {
+        std::unique_lock lk(chunks_mutex_);
+        auto entry_iterator = chunks_index_.find(GetChunkKey(chunk->pos_x_, chunk->pos_z_));
+        if (entry_iterator == chunks_index_.end() || entry_iterator->second.chunk != chunk)
+        {
+            return;
+        }
 
-        if (chunk_iterator != std::end(requested_chunks_))
+        auto &entry = entry_iterator->second;
+        if (entry.state == ChunkState::Rejected)
         {
-            return *chunk_iterator;
+            return;
         }
 
-        // Check if chunk is waiting to be rejected
-        std::unique_lock lk_rejected(rejected_chunks_mutex_);
-        chunk_iterator = std::find_if(rejected_chunks_.begin(), rejected_chunks_.end(), find_chunk_predicate);
+        // A running job may have read the blocks before the edit, the chunk is queued again once it is done
+        if (entry.is_meshing)
+        {
+            entry.is_mesh_pending = true;
+            return;
+        }
 
-        if (chunk_iterator != std::end(rejected_chunks_))
+        // Queued jobs and first meshes pick up the dirty sections on their own
+        if (!entry.is_meshed || entry.is_mesh_pending)
         {
-            result = *chunk_iterator;
-            // If so it's no longer to be rejected
-            rejected_chunks_.remove_if(find_chunk_predicate);
-            return result;
+            return;
         }
-        lk_rejected.unlock();
 
-        // If chunk is neither to be processed nor rejected create it and put to be processed
-        result = chunk_builder_->InitializeChunk(chunk_x, chunk_z);
-        requested_chunks_.emplace_back(result);
-        lk_requested.unlock();
-        std::lock_guard lg(creator_mutex_);
-        //std::unique_lock lk_createor(creator_mutex_);
-        any_requested_.notify_one();
-        return result;
+        entry.is_meshing = true;
+        entry.cancellation_token = CancellationToken::Create();
+        auto cancellation_token = entry.cancellation_token;
+        auto lod_level = entry.lod_level;
+        auto meshed_lod_level = entry.meshed_lod_level;
+        lk.unlock();
+
+        // Only a few sections are dirty after an edit, meshing them here keeps the change within the frame
+        auto sections_mask = chunk->TakeDirtySections();
+        if (lod_level != meshed_lod_level)
+        {
+            sections_mask = Chunk::all_sections_mask;
+        }
+        auto mesh = world_optimizer_->MeshChunk(*chunk, cancellation_token, sections_mask, lod_level);
+        auto is_completed = mesh != nullptr && world_optimizer_->UploadChunk(*chunk, mesh, cancellation_token);
+        if (!is_completed)
+        {
+            chunk->MarkSectionsDirty(sections_mask);
+        }
+
+        lk.lock();
+        entry_iterator = chunks_index_.find(GetChunkKey(chunk->pos_x_, chunk->pos_z_));
+        if (entry_iterator != chunks_index_.end() && entry_iterator->second.chunk == chunk)
+        {
+            CompleteMeshing(entry_iterator, is_completed);
+        }
+
+        lk.unlock();
+        NotifyWorkers();
     }
 
-    void ChunksProcessor::RejectChunk(std::shared_ptr<Chunk> chunk)
+    std::optional<ChunksProcessor::ChunkState> ChunksProcessor::GetChunkState(int32_t chunk_x, int32_t chunk_z)
     {
-        auto find_chunk_predicate = [&](const std::shared_ptr<Chunk> &chunk_arg)
+        std::lock_guard lg(chunks_mutex_);
+        auto entry_iterator = chunks_index_.find(GetChunkKey(chunk_x, chunk_z));
+        if (entry_iterator == chunks_index_.end())
         {
-            return chunk == chunk_arg;
-        };
+            return std::nullopt;
+        }
 
-        std::lock_guard lg_requested(requested_chunks_mutex_);
-        requested_chunks_.remove_if(find_chunk_predicate);
+        return entry_iterator->second.state;
+    }
+
+    void ChunksProcessor::UpdateLevelsOfDetail()
+    {
+        auto origin = metric_.GetOriginChunkPosition();
+        if (lod_origin_ == origin)
+        {
+            return;
+        }
+        lod_origin_ = origin;
 
-        // Only initialized chunks requires clean up
-        if (chunk->initialized_)
+        std::unique_lock lk(chunks_mutex_);
+        bool is_scheduled = false;
+        for (auto &[key, entry] : chunks_index_)
         {
-            std::lock_guard lg_rejected(rejected_chunks_mutex_);
-            rejected_chunks_.emplace_back(chunk);
-            std::lock_guard lg_disposal(disposal_mutex_);
-            any_rejected_.notify_one();
+            // Chunks not meshed yet pick their level when the job starts
+            if (entry.state == ChunkState::Rejected || (!entry.is_meshed && !entry.is_meshing))
+            {
+                continue;
+            }
+
+            if (GetLevelOfDetail(entry.chunk->pos_x_, entry.chunk->pos_z_, origin) != entry.lod_level)
+            {
+                is_scheduled = ScheduleMeshing(entry) || is_scheduled;
+            }
         }
+
+        if (is_scheduled)
+        {
+            lk.unlock();
+            NotifyWorkers();
+        }
+    }
+
+    bool ChunksProcessor::IsBusy() const
+    {
+        return busy_workers_count_ > 0;
     }
 
-    std::shared_ptr<Chunk> ChunksProcessor::GetNextChunkToCreate()
+    size_t ChunksProcessor::GetWorkersCount() const
     {
-        std::lock_guard lk(requested_chunks_mutex_);
-        if (requested_chunks_.empty() || stop_)
+        return workers_.size() + meshing_threads_.size() + upload_threads_.size();
+    }
+
+    WorldOptimizer &ChunksProcessor::GetWorldOptimizer()
+    {
+        return *world_optimizer_;
+    }
+
+    uint32_t ChunksProcessor::GetDefaultWorkersCount()
+    {
+        auto hardware_concurrency = std::thread::hardware_concurrency();
+        return hardware_concurrency > 1 ? hardware_concurrency - 1 : 1;
+    }
+
+    void ChunksProcessor::NotifyWorkers()
+    {
+        std::lock_guard lg(work_mutex_);
+        any_work_.notify_all();
+    }
+
+    void ChunksProcessor::WaitForWork(const std::function<bool()> &has_pending_work)
+    {
+        std::unique_lock lk(work_mutex_);
+        any_work_.wait(lk, [this, &has_pending_work]
+                       { return stop_ || has_pending_work(); });
+    }
+
+    uint64_t ChunksProcessor::GetChunkKey(int32_t chunk_x, int32_t chunk_z)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(chunk_x)) << 32) | static_cast<uint32_t>(chunk_z);
+    }
+
+    uint32_t ChunksProcessor::GetLevelOfDetail(int32_t chunk_x, int32_t chunk_z, std::pair<int32_t, int32_t> origin) const
+    {
+        auto distance = static_cast<uint32_t>(std::max(std::abs(chunk_x - origin.first), std::abs(chunk_z - origin.second)));
+
+        uint32_t lod_level = 0;
+        while (lod_level < lod_distances_.size() && distance >= lod_distances_[lod_level])
+        {
+            ++lod_level;
+        }
+
+        return lod_level;
+    }
+
+    ChunksProcessor::ChunkEntry *ChunksProcessor::FindEntry(const std::shared_ptr<Chunk> &chunk, ChunkState state)
+    {
+        auto entry_iterator = chunks_index_.find(GetChunkKey(chunk->pos_x_, chunk->pos_z_));
+        if (entry_iterator == chunks_index_.end() || entry_iterator->second.chunk != chunk || entry_iterator->second.state != state)
         {
             return nullptr;
         }
 
-        auto compare = [&](const std::shared_ptr<Chunk> &first, const std::shared_ptr<Chunk> &second) -> bool
+        return &entry_iterator->second;
+    }
+
+    ChunksProcessor::ChunkJob ChunksProcessor::StartChunkJob(std::shared_ptr<Chunk> chunk)
+    {
+        auto entry = FindEntry(chunk, ChunkState::Requested);
+        if (entry == nullptr)
         {
-            return metric_.Compare(first, second);
-        };
+            return ChunkJob();
+        }
 
-        requested_chunks_.sort(compare);
-        auto result = requested_chunks_.back();
-        requested_chunks_.pop_back();
+        entry->state = ChunkState::Generating;
+        entry->cancellation_token = CancellationToken::Create();
+        ++busy_workers_count_;
 
-        return result;
+        return ChunkJob{std::move(chunk), entry->cancellation_token};
     }
 
-    std::shared_ptr<Chunk> ChunksProcessor::GetNextChunkToDispose()
+    ChunksProcessor::ChunkJob ChunksProcessor::GetNextChunkToCreate(Worker &worker)
     {
-        std::lock_guard lk(rejected_chunks_mutex_);
-        if (rejected_chunks_.empty() || stop_)
+        std::lock_guard lk(chunks_mutex_);
+        if (stop_)
         {
-            return nullptr;
+            return ChunkJob();
         }
 
-        auto result = rejected_chunks_.back();
-        rejected_chunks_.pop_back();
+        while (true)
+        {
+            if (worker.chunks.empty() && !requested_chunks_.IsEmpty())
+            {
+                auto [origin_x, origin_z] = metric_.GetOriginChunkPosition();
+                requested_chunks_.SetOrigin(origin_x, origin_z);
 
-        return result;
+                for (size_t i = 0; i < refill_batch_size && !requested_chunks_.IsEmpty(); ++i)
+                {
+                    worker.chunks.push_back(requested_chunks_.Pop());
+                }
+            }
+
+            if (worker.chunks.empty())
+            {
+                return ChunkJob();
+            }
+
+            auto job = StartChunkJob(std::move(worker.chunks.front()));
+            worker.chunks.pop_front();
+
+            if (job.chunk != nullptr)
+            {
+                return job;
+            }
+        }
     }
 
-    void ChunksProcessor::CreatorCallback()
+    ChunksProcessor::ChunkJob ChunksProcessor::GetNextChunkToMesh()
     {
-        std::unique_lock lk(creator_mutex_);
-        while (!stop_)
+        std::lock_guard lk(chunks_mutex_);
+        std::optional<std::pair<int32_t, int32_t>> origin;
+        while (!meshing_chunks_.empty() && upload_slots_count_ < upload_queue_capacity_ && !stop_)
         {
-            if(!lk.owns_lock())
+            auto chunk = std::move(meshing_chunks_.front());
+            meshing_chunks_.pop_front();
+
+            auto entry_iterator = chunks_index_.find(GetChunkKey(chunk->pos_x_, chunk->pos_z_));
+            if (entry_iterator == chunks_index_.end() || entry_iterator->second.chunk != chunk)
             {
-                lk.lock();
+                continue;
             }
-            any_requested_.wait(lk);
-            lk.unlock();
-            current_to_create_ = GetNextChunkToCreate();
-            while (current_to_create_ != nullptr)
+
+            // Rejected chunks keep the pending flag so that the meshing resumes if they are requested again
+            auto &entry = entry_iterator->second;
+            if (entry.state == ChunkState::Rejected || !entry.is_mesh_pending || entry.is_meshing)
+            {
+                continue;
+            }
+
+            if (!origin.has_value())
+            {
+                origin = metric_.GetOriginChunkPosition();
+            }
+
+            entry.lod_level = GetLevelOfDetail(chunk->pos_x_, chunk->pos_z_, *origin);
+
+            // The first mesh and a change of level cover every section, other ones only what got dirty since
+            auto sections_mask = chunk->TakeDirtySections();
+            if (!entry.is_meshed || entry.lod_level != entry.meshed_lod_level)
+            {
+                sections_mask = Chunk::all_sections_mask;
+            }
+
+            entry.is_mesh_pending = false;
+            entry.is_meshing = true;
+            entry.cancellation_token = CancellationToken::Create();
+            ++upload_slots_count_;
+            ++busy_workers_count_;
+
+            return ChunkJob{std::move(chunk), entry.cancellation_token, sections_mask, entry.lod_level};
+        }
+
+        return ChunkJob();
+    }
+
+    ChunksProcessor::ChunkUpload ChunksProcessor::GetNextChunkToUpload()
+    {
+        std::lock_guard lk(chunks_mutex_);
+        if (uploading_chunks_.empty() || stop_)
+        {
+            return ChunkUpload();
+        }
+
+        auto upload = std::move(uploading_chunks_.front());
+        uploading_chunks_.pop_front();
+        ++busy_workers_count_;
+
+        return upload;
+    }
+
+    std::shared_ptr<Chunk> ChunksProcessor::GetNextChunkToDispose()
+    {
+        std::lock_guard lk(chunks_mutex_);
+        while (!rejected_chunks_.empty() && !stop_)
+        {
+            auto chunk = std::move(rejected_chunks_.front());
+            rejected_chunks_.pop_front();
+
+            if (FindEntry(chunk, ChunkState::Rejected) != nullptr)
+            {
+                chunks_index_.erase(GetChunkKey(chunk->pos_x_, chunk->pos_z_));
+                ++busy_workers_count_;
+                return chunk;
+            }
+        }
+
+        return nullptr;
+    }
+
+    ChunksProcessor::ChunkJob ChunksProcessor::StealChunk(Worker &thief)
+    {
+        std::lock_guard lk(chunks_mutex_);
+        if (stop_)
+        {
+            return ChunkJob();
+        }
+
+        // Victims keep their nearest chunks at the front, so steal the farthest one from the back
+        for (auto &victim : workers_)
+        {
+            if (victim.get() == &thief)
             {
-                if (chunk_builder_->GenerateChunkStep(current_to_create_))
+                continue;
+            }
+
+            while (!victim->chunks.empty())
+            {
+                auto job = StartChunkJob(std::move(victim->chunks.back()));
+                victim->chunks.pop_back();
+
+                if (job.chunk != nullptr)
                 {
-                    world_optimizer_->OptimizeChunk(*current_to_create_);
-                    scene_->AddGameObject(current_to_create_);
-                    current_to_create_ = stop_processing ? nullptr : GetNextChunkToCreate();
+                    return job;
                 }
             }
         }
+
+        return ChunkJob();
+    }
+
+    bool ChunksProcessor::HasPendingGeneration()
+    {
+        std::lock_guard lk(chunks_mutex_);
+        if (!rejected_chunks_.empty() || !requested_chunks_.IsEmpty())
+        {
+            return true;
+        }
+
+        for (auto &worker : workers_)
+        {
+            if (!worker->chunks.empty())
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool ChunksProcessor::HasPendingMeshing()
+    {
+        std::lock_guard lk(chunks_mutex_);
+        return !meshing_chunks_.empty() && upload_slots_count_ < upload_queue_capacity_;
+    }
+
+    bool ChunksProcessor::HasPendingUpload()
+    {
+        std::lock_guard lk(chunks_mutex_);
+        return !uploading_chunks_.empty();
+    }
+
+    bool ChunksProcessor::AreNeighborsGenerated(int32_t chunk_x, int32_t chunk_z)
+    {
+        // Neighbors that are not indexed lie outside the window and are never waited for
+        for (auto [offset_x, offset_z] : neighbor_offsets)
+        {
+            auto entry_iterator = chunks_index_.find(GetChunkKey(chunk_x + offset_x, chunk_z + offset_z));
+            if (entry_iterator != chunks_index_.end() && !entry_iterator->second.is_generated)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool ChunksProcessor::ScheduleMeshing(ChunkEntry &entry)
+    {
+        if (!entry.is_generated || entry.is_mesh_pending)
+        {
+            return false;
+        }
+
+        if (!entry.is_meshed && !AreNeighborsGenerated(entry.chunk->pos_x_, entry.chunk->pos_z_))
+        {
+            return false;
+        }
+
+        // A border next to new blocks may show or hide faces in any section
+        entry.chunk->MarkSectionsDirty(Chunk::all_sections_mask);
+
+        // A chunk being meshed right now is queued again by its worker once done
+        entry.is_mesh_pending = true;
+        if (!entry.is_meshing)
+        {
+            meshing_chunks_.push_back(entry.chunk);
+        }
+
+        return true;
+    }
+
+    bool ChunksProcessor::ScheduleNeighborsMeshing(int32_t chunk_x, int32_t chunk_z, bool is_generated)
+    {
+        bool is_scheduled = false;
+        for (auto [offset_x, offset_z] : neighbor_offsets)
+        {
+            auto entry_iterator = chunks_index_.find(GetChunkKey(chunk_x + offset_x, chunk_z + offset_z));
+            if (entry_iterator == chunks_index_.end())
+            {
+                continue;
+            }
+
+            // Meshed neighbors only need a new border when there are new blocks next to them,
+            // coarse ones never look at their neighbors
+            auto &neighbor = entry_iterator->second;
+            if (neighbor.is_meshed && (!is_generated || neighbor.lod_level > 0))
+            {
+                continue;
+            }
+
+            is_scheduled = ScheduleMeshing(neighbor) || is_scheduled;
+        }
+
+        return is_scheduled;
     }
 
-    void ChunksProcessor::DisposalCallback()
+    void ChunksProcessor::WorkerCallback(Worker &worker)
     {
-        std::unique_lock lk(disposal_mutex_);
         while (!stop_)
         {
-            if(!lk.owns_lock())
+            auto chunk_to_dispose = GetNextChunkToDispose();
+            if (chunk_to_dispose != nullptr)
             {
-                lk.lock();
+                DisposeChunk(chunk_to_dispose);
+                --busy_workers_count_;
+                continue;
             }
-            any_rejected_.wait(lk);
-            lk.unlock();
-            current_to_dispose_ = GetNextChunkToDispose();
-            while(current_to_dispose_ != nullptr)
+
+            auto job = GetNextChunkToCreate(worker);
+            if (job.chunk == nullptr)
+            {
+                job = StealChunk(worker);
+            }
+
+            if (job.chunk != nullptr)
+            {
+                CreateChunk(job);
+                --busy_workers_count_;
+                continue;
+            }
+
+            WaitForWork([this]
+                        { return HasPendingGeneration(); });
+        }
+    }
+
+    void ChunksProcessor::MeshingWorkerCallback()
+    {
+        while (!stop_)
+        {
+            auto job = GetNextChunkToMesh();
+            if (job.chunk != nullptr)
             {
-                if (chunk_builder_->DisposeChunkStep(current_to_dispose_))
+                MeshChunk(job);
+                --busy_workers_count_;
+                continue;
+            }
+
+            WaitForWork([this]
+                        { return HasPendingMeshing(); });
+        }
+    }
+
+    void ChunksProcessor::UploadWorkerCallback()
+    {
+        while (!stop_)
+        {
+            auto upload = GetNextChunkToUpload();
+            if (upload.chunk != nullptr)
+            {
+                UploadChunk(upload);
+                --busy_workers_count_;
+                continue;
+            }
+
+            WaitForWork([this]
+                        { return HasPendingUpload(); });
+        }
+    }
+
+    void ChunksProcessor::CreateChunk(const ChunkJob &job)
+    {
+        auto &chunk = job.chunk;
+        auto &cancellation_token = job.cancellation_token;
+
+        bool is_completed;
+        if (time_sliced_generation)
+        {
+            is_completed = true;
+            while (!chunk_builder_->GenerateChunkStep(chunk))
+            {
+                if (cancellation_token.IsCancelled())
                 {
-                    world_optimizer_->DisposeChunk(*current_to_dispose_);
-                    current_to_dispose_ = stop_processing ? nullptr : GetNextChunkToDispose();
+                    chunk_builder_->CancelChunk(chunk);
+                    is_completed = false;
+                    break;
                 }
             }
         }
+        else
+        {
+            is_completed = chunk_builder_->GenerateChunk(chunk, cancellation_token);
+        }
+
+        std::unique_lock lk(chunks_mutex_);
+        auto entry_iterator = chunks_index_.find(GetChunkKey(chunk->pos_x_, chunk->pos_z_));
+        if (entry_iterator == chunks_index_.end() || entry_iterator->second.chunk != chunk)
+        {
+            return;
+        }
+
+        auto &entry = entry_iterator->second;
+        bool is_scheduled;
+        if (entry.state == ChunkState::Rejected)
+        {
+            // Rejected while being generated, it never reached the scene so there is nothing to dispose
+            chunks_index_.erase(entry_iterator);
+            is_scheduled = ScheduleNeighborsMeshing(chunk->pos_x_, chunk->pos_z_, false);
+        }
+        else if (!is_completed)
+        {
+            // Requested again after the job got cancelled, start over
+            entry.state = ChunkState::Requested;
+            requested_chunks_.Push(chunk);
+            is_scheduled = true;
+        }
+        else
+        {
+            entry.is_generated = true;
+            is_scheduled = ScheduleMeshing(entry);
+            is_scheduled = ScheduleNeighborsMeshing(chunk->pos_x_, chunk->pos_z_, true) || is_scheduled;
+        }
+
+        if (is_scheduled)
+        {
+            lk.unlock();
+            NotifyWorkers();
+        }
+    }
+
+    void ChunksProcessor::MeshChunk(const ChunkJob &job)
+    {
+        auto &[chunk, cancellation_token, sections_mask, lod_level] = job;
+
+        auto mesh = world_optimizer_->MeshChunk(*chunk, cancellation_token, sections_mask, lod_level);
+
+        std::unique_lock lk(chunks_mutex_);
+        auto entry_iterator = chunks_index_.find(GetChunkKey(chunk->pos_x_, chunk->pos_z_));
+        if (entry_iterator != chunks_index_.end() && entry_iterator->second.chunk != chunk)
+        {
+            entry_iterator = chunks_index_.end();
+        }
+
+        if (mesh != nullptr && entry_iterator != chunks_index_.end() && entry_iterator->second.state != ChunkState::Rejected)
+        {
+            // The upload slot taken for this job is released once the upload is done
+            uploading_chunks_.push_back(ChunkUpload{chunk, std::move(mesh), cancellation_token});
+        }
+        else
+        {
+            --upload_slots_count_;
+            chunk->MarkSectionsDirty(sections_mask);
+            if (entry_iterator != chunks_index_.end())
+            {
+                CompleteMeshing(entry_iterator, false);
+            }
+        }
+
+        lk.unlock();
+        NotifyWorkers();
+    }
+
+    void ChunksProcessor::UploadChunk(const ChunkUpload &upload)
+    {
+        auto &[chunk, mesh, cancellation_token] = upload;
+
+        auto is_completed = world_optimizer_->UploadChunk(*chunk, mesh, cancellation_token);
+        if (!is_completed)
+        {
+            chunk->MarkSectionsDirty(mesh->GetUpdatedSectionsMask());
+        }
+
+        std::unique_lock lk(chunks_mutex_);
+        --upload_slots_count_;
+
+        auto entry_iterator = chunks_index_.find(GetChunkKey(chunk->pos_x_, chunk->pos_z_));
+        if (entry_iterator != chunks_index_.end() && entry_iterator->second.chunk == chunk)
+        {
+            CompleteMeshing(entry_iterator, is_completed);
+        }
+
+        lk.unlock();
+        NotifyWorkers();
+    }
+
+    void ChunksProcessor::CompleteMeshing(std::unordered_map<uint64_t, ChunkEntry>::iterator entry_iterator, bool is_completed)
+    {
+        auto &entry = entry_iterator->second;
+        auto chunk = entry.chunk;
+        entry.is_meshing = false;
+
+        if (entry.state == ChunkState::Rejected)
+        {
+            // Meshed chunks are disposed from the rejected queue, the others never reached the scene
+            if (!entry.is_meshed)
+            {
+                chunks_index_.erase(entry_iterator);
+                ScheduleNeighborsMeshing(chunk->pos_x_, chunk->pos_z_, false);
+            }
+            return;
+        }
+
+        if (!is_completed)
+        {
+            // Requested again after the job got cancelled, mesh once more
+            entry.is_mesh_pending = true;
+        }
+        else
+        {
+            entry.meshed_lod_level = entry.lod_level;
+            if (!entry.is_meshed)
+            {
+                // Added under the lock so that a concurrent rejection can not dispose it before it is in the scene
+                entry.is_meshed = true;
+                entry.state = ChunkState::Ready;
+                scene_->AddGameObject(chunk);
+            }
+        }
+
+        if (entry.is_mesh_pending)
+        {
+            meshing_chunks_.push_back(chunk);
+        }
+    }
+
+    void ChunksProcessor::DisposeChunk(std::shared_ptr<Chunk> chunk)
+    {
+        while (!chunk_builder_->DisposeChunkStep(chunk))
+        {
+        }
+
+        world_optimizer_->DisposeChunk(*chunk);
     }
 }
\ No newline at end of file
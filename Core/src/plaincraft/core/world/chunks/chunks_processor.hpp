@@ -32,15 +32,33 @@ SOFTWARE.
 #include "../../entities/map/chunk.hpp"
 #include "../../scene/scene.hpp"
 #include "./chunk_builder_base.hpp"
-#include <list>
+#include "./chunks_priority_queue.hpp"
+#include <array>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
 
 namespace plaincraft_core
 {
+    // Worker counts of the generation, meshing and upload stages, zero picks a default from the hardware.
+    // Chunks at least lod_distances[i] chunks away from the origin are meshed at level of detail i + 1.
+    struct ChunksPipelineConfig
+    {
+        uint32_t generation_workers_count = 0;
+        uint32_t meshing_workers_count = 0;
+        uint32_t upload_workers_count = 1;
+        size_t upload_queue_capacity = 32;
+        std::array<uint32_t, WorldOptimizer::lod_levels_count - 1> lod_distances = {{3, 5, 7}};
+    };
+
     class ChunksProcessor
     {
     public:
@@ -56,36 +74,90 @@ namespace plaincraft_core
             Metric &operator=(const Metric &other);
             Metric &operator=(Metric &&other) noexcept;
 
-            bool Compare(const std::shared_ptr<Chunk> &first, const std::shared_ptr<Chunk> &second);
+            std::pair<int32_t, int32_t> GetOriginChunkPosition() const;
         };
 
     public:
-        std::atomic<bool> stop_processing = false;
+        std::atomic<bool> time_sliced_generation = false;
 
         class WorldGenerator;
         friend class WorldGenerator;
 
+        static constexpr size_t refill_batch_size = 2;
+        static constexpr std::array<std::pair<int32_t, int32_t>, 4> neighbor_offsets{{{-1, 0}, {1, 0}, {0, -1}, {0, 1}}};
+
+        enum class ChunkState
+        {
+            Requested,
+            Generating,
+            Ready,
+            Rejected
+        };
+
+    private:
+        // A generated chunk stays Generating until its first mesh, which waits for the neighbors inside the window
+        struct ChunkEntry
+        {
+            std::shared_ptr<Chunk> chunk;
+            ChunkState state;
+            bool is_generated = false;
+            bool is_meshed = false;
+            bool is_mesh_pending = false;
+            bool is_meshing = false;
+            uint32_t lod_level = 0;
+            // Level the mesh in the scene was built at, sections of another level can not be reused
+            uint32_t meshed_lod_level = 0;
+            CancellationToken cancellation_token;
+        };
+
+        struct ChunkJob
+        {
+            std::shared_ptr<Chunk> chunk;
+            CancellationToken cancellation_token;
+            Chunk::SectionsMask sections_mask = Chunk::all_sections_mask;
+            uint32_t lod_level = 0;
+        };
+
+        struct ChunkUpload
+        {
+            std::shared_ptr<Chunk> chunk;
+            std::shared_ptr<ChunkMesh const> mesh;
+            CancellationToken cancellation_token;
+        };
+
+        struct Worker
+        {
+            std::thread thread;
+            std::deque<std::shared_ptr<Chunk>> chunks;
+        };
+
     public:
         std::unique_ptr<ChunkBuilderBase> chunk_builder_;
         std::unique_ptr<WorldOptimizer> world_optimizer_;
         Metric metric_;
         std::shared_ptr<Scene> scene_;
 
-        std::list<std::shared_ptr<Chunk>> requested_chunks_;
-        std::list<std::shared_ptr<Chunk>> rejected_chunks_;
-        std::mutex requested_chunks_mutex_;
-        std::mutex rejected_chunks_mutex_;
+        // Queues may hold stale chunks, the index is the source of truth and is checked on every pop
+        std::unordered_map<uint64_t, ChunkEntry> chunks_index_;
+        ChunksPriorityQueue requested_chunks_;
+        std::deque<std::shared_ptr<Chunk>> meshing_chunks_;
+        std::deque<ChunkUpload> uploading_chunks_;
+        std::deque<std::shared_ptr<Chunk>> rejected_chunks_;
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::vector<std::thread> meshing_threads_;
+        std::vector<std::thread> upload_threads_;
+        std::mutex chunks_mutex_;
 
-        std::shared_ptr<Chunk> current_to_create_ = nullptr;
-        std::shared_ptr<Chunk> current_to_dispose_ = nullptr;
+        // Meshes being built count against the upload queue too, so meshing stalls before the queue overflows
+        size_t upload_queue_capacity_;
+        size_t upload_slots_count_ = 0;
 
-        std::thread creator_thread_;
-        std::thread disposal_thread_;
-        std::mutex creator_mutex_;
-        std::mutex disposal_mutex_;
-        std::condition_variable any_requested_;
-        std::condition_variable any_rejected_;
+        std::array<uint32_t, WorldOptimizer::lod_levels_count - 1> lod_distances_;
+        std::optional<std::pair<int32_t, int32_t>> lod_origin_;
 
+        std::mutex work_mutex_;
+        std::condition_variable any_work_;
+        std::atomic<uint32_t> busy_workers_count_{0};
 
     private:
         std::atomic<bool> stop_{false};
@@ -95,7 +167,8 @@ namespace plaincraft_core
             std::unique_ptr<ChunkBuilderBase> chunk_builder,
             std::unique_ptr<WorldOptimizer> world_optimizer,
             std::shared_ptr<Scene> scene,
-            Metric metric);
+            Metric metric,
+            ChunksPipelineConfig config = ChunksPipelineConfig());
 
         ChunksProcessor(const ChunksProcessor &other) = delete;
         ChunksProcessor(ChunksProcessor &&other) noexcept;
@@ -107,12 +180,49 @@ namespace plaincraft_core
         std::shared_ptr<Chunk> RequestChunk(int32_t chunk_x, int32_t chunk_z);
         void RejectChunk(std::shared_ptr<Chunk> chunk);
 
+        // Remeshes the dirty sections of an edited chunk, right away when no job is meshing it
+        void RemeshChunk(std::shared_ptr<Chunk> chunk);
+        std::optional<ChunkState> GetChunkState(int32_t chunk_x, int32_t chunk_z);
+
+        // Remeshes chunks that crossed a level of detail ring since the origin last moved to another chunk
+        void UpdateLevelsOfDetail();
+
+        bool IsBusy() const;
+        size_t GetWorkersCount() const;
+
+        WorldOptimizer &GetWorldOptimizer();
+
+        static uint32_t GetDefaultWorkersCount();
+
     private:
-        std::shared_ptr<Chunk> GetNextChunkToCreate();
+        static uint64_t GetChunkKey(int32_t chunk_x, int32_t chunk_z);
+        uint32_t GetLevelOfDetail(int32_t chunk_x, int32_t chunk_z, std::pair<int32_t, int32_t> origin) const;
+        ChunkEntry *FindEntry(const std::shared_ptr<Chunk> &chunk, ChunkState state);
+
+        ChunkJob StartChunkJob(std::shared_ptr<Chunk> chunk);
+        ChunkJob GetNextChunkToCreate(Worker &worker);
+        ChunkJob GetNextChunkToMesh();
+        ChunkUpload GetNextChunkToUpload();
         std::shared_ptr<Chunk> GetNextChunkToDispose();
-
-        void CreatorCallback();
-        void DisposalCallback();
+        ChunkJob StealChunk(Worker &thief);
+        bool HasPendingGeneration();
+        bool HasPendingMeshing();
+        bool HasPendingUpload();
+
+        bool AreNeighborsGenerated(int32_t chunk_x, int32_t chunk_z);
+        bool ScheduleMeshing(ChunkEntry &entry);
+        bool ScheduleNeighborsMeshing(int32_t chunk_x, int32_t chunk_z, bool is_generated);
+
+        void NotifyWorkers();
+        void WaitForWork(const std::function<bool()> &has_pending_work);
+        void WorkerCallback(Worker &worker);
+        void MeshingWorkerCallback();
+        void UploadWorkerCallback();
+        void CreateChunk(const ChunkJob &job);
+        void MeshChunk(const ChunkJob &job);
+        void UploadChunk(const ChunkUpload &upload);
+        void CompleteMeshing(std::unordered_map<uint64_t, ChunkEntry>::iterator entry_iterator, bool is_completed);
+        void DisposeChunk(std::shared_ptr<Chunk> chunk);
     };
 }
 
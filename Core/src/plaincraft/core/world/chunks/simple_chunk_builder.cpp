@@ -25,7 +25,7 @@ SOFTWARE.
 */
 
 #include "simple_chunk_builder.hpp"
-#include "../../entities/blocks/stone.hpp"
+#include "../../entities/blocks/block_id.hpp"
 
 namespace plaincraft_core
 {
@@ -35,18 +35,7 @@ namespace plaincraft_core
 
     bool SimpleChunkBuilder::GenerateChunkStep(std::shared_ptr<Chunk> chunk)
     {
-        auto chunk_x = chunk->GetPositionX();
-        auto chunk_z = chunk->GetPositionZ();
-
-        std::shared_ptr<Block> game_object;
-        game_object = std::make_shared<Stone>();
-        auto physics_object = std::make_shared<PhysicsObject>();
-        physics_object->size = Vector3d(1.0f, 1.0f, 1.0f);
-        physics_object->type = PhysicsObject::ObjectType::Static;
-        auto offset = Vector3d(8.0f, 15.0f, 8.0f);
-        physics_object->position = Vector3d(chunk_x, 0.0f, chunk_z) + offset;
-        game_object->SetPhysicsObject(physics_object);
-        chunk->blocks_[8][15][8] = game_object;
+        chunk->SetBlock(8, 15, 8, BlockIds::stone);
 
         chunk->initialized_ = true;
         return true;
@@ -55,12 +44,6 @@ namespace plaincraft_core
     bool SimpleChunkBuilder::DisposeChunkStep(std::shared_ptr<Chunk> chunk)
     {
         scene_->RemoveGameObject(chunk);
-        auto &blocks = chunk->GetData();
-        auto &block = blocks[8][15][8];
-        if (block != nullptr)
-        {
-            scene_->RemoveGameObject(block);
-        }
         return true;
     }
 }
\ No newline at end of file
@@ -0,0 +1,131 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "face_culling_kernel.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PLAINCRAFT_CULLING_AVX2
+#elif defined(__SSE4_2__) || defined(PLAINCRAFT_SIMD_SSE42)
+#include <nmmintrin.h>
+#define PLAINCRAFT_CULLING_SSE42
+#endif
+
+namespace plaincraft_core
+{
+    namespace
+    {
+        constexpr uint32_t top_face = 0;
+        constexpr uint32_t bottom_face = 1;
+        constexpr uint32_t left_face = 2;
+        constexpr uint32_t right_face = 3;
+        constexpr uint32_t front_face = 4;
+        constexpr uint32_t back_face = 5;
+
+        // Rows of the padded opaque grid next to the row of y and z, the x neighbors are read from the row itself
+        inline uint32_t GetPaddedIndex(uint32_t y, uint32_t z)
+        {
+            return (y + 1) * FaceCullingKernel::padded_size + z + 1;
+        }
+    }
+
+    void FaceCullingKernel::CullFaces(const Occupancy &occupancy, FaceMasks &faces)
+    {
+        auto solid = occupancy.solid.data();
+        auto opaque = occupancy.opaque.data();
+
+        for (uint32_t y = 0; y < size; ++y)
+        {
+#if defined(PLAINCRAFT_CULLING_AVX2)
+            for (uint32_t z = 0; z < size; z += 8)
+            {
+                auto center = GetPaddedIndex(y, z);
+                auto row = y * size + z;
+
+                auto solid_rows = _mm256_load_si256(reinterpret_cast<const __m256i *>(solid + row));
+                auto center_rows = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(opaque + center));
+                auto top_rows = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(opaque + center + padded_size));
+                auto bottom_rows = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(opaque + center - padded_size));
+                auto front_rows = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(opaque + center - 1));
+                auto back_rows = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(opaque + center + 1));
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(faces[top_face].data() + row), _mm256_andnot_si256(_mm256_srli_epi32(top_rows, 1), solid_rows));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(faces[bottom_face].data() + row), _mm256_andnot_si256(_mm256_srli_epi32(bottom_rows, 1), solid_rows));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(faces[left_face].data() + row), _mm256_andnot_si256(center_rows, solid_rows));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(faces[right_face].data() + row), _mm256_andnot_si256(_mm256_srli_epi32(center_rows, 2), solid_rows));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(faces[front_face].data() + row), _mm256_andnot_si256(_mm256_srli_epi32(front_rows, 1), solid_rows));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(faces[back_face].data() + row), _mm256_andnot_si256(_mm256_srli_epi32(back_rows, 1), solid_rows));
+            }
+#elif defined(PLAINCRAFT_CULLING_SSE42)
+            for (uint32_t z = 0; z < size; z += 4)
+            {
+                auto center = GetPaddedIndex(y, z);
+                auto row = y * size + z;
+
+                auto solid_rows = _mm_load_si128(reinterpret_cast<const __m128i *>(solid + row));
+                auto center_rows = _mm_loadu_si128(reinterpret_cast<const __m128i *>(opaque + center));
+                auto top_rows = _mm_loadu_si128(reinterpret_cast<const __m128i *>(opaque + center + padded_size));
+                auto bottom_rows = _mm_loadu_si128(reinterpret_cast<const __m128i *>(opaque + center - padded_size));
+                auto front_rows = _mm_loadu_si128(reinterpret_cast<const __m128i *>(opaque + center - 1));
+                auto back_rows = _mm_loadu_si128(reinterpret_cast<const __m128i *>(opaque + center + 1));
+
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(faces[top_face].data() + row), _mm_andnot_si128(_mm_srli_epi32(top_rows, 1), solid_rows));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(faces[bottom_face].data() + row), _mm_andnot_si128(_mm_srli_epi32(bottom_rows, 1), solid_rows));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(faces[left_face].data() + row), _mm_andnot_si128(center_rows, solid_rows));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(faces[right_face].data() + row), _mm_andnot_si128(_mm_srli_epi32(center_rows, 2), solid_rows));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(faces[front_face].data() + row), _mm_andnot_si128(_mm_srli_epi32(front_rows, 1), solid_rows));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(faces[back_face].data() + row), _mm_andnot_si128(_mm_srli_epi32(back_rows, 1), solid_rows));
+            }
+#else
+            for (uint32_t z = 0; z < size; ++z)
+            {
+                auto center = GetPaddedIndex(y, z);
+                auto row = y * size + z;
+                auto solid_row = solid[row];
+
+                // The padded row keeps block x in bit x + 1, so bit x is the left neighbor and bit x + 2 the right one
+                faces[top_face][row] = solid_row & ~(opaque[center + padded_size] >> 1);
+                faces[bottom_face][row] = solid_row & ~(opaque[center - padded_size] >> 1);
+                faces[left_face][row] = solid_row & ~opaque[center];
+                faces[right_face][row] = solid_row & ~(opaque[center] >> 2);
+                faces[front_face][row] = solid_row & ~(opaque[center - 1] >> 1);
+                faces[back_face][row] = solid_row & ~(opaque[center + 1] >> 1);
+            }
+#endif
+        }
+    }
+
+    const char *FaceCullingKernel::GetInstructionSet()
+    {
+#if defined(PLAINCRAFT_CULLING_AVX2)
+        return "AVX2";
+#elif defined(PLAINCRAFT_CULLING_SSE42)
+        return "SSE4.2";
+#else
+        return "None";
+#endif
+    }
+}
@@ -0,0 +1,62 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_CORE_FACE_CULLING_KERNEL
+#define PLAINCRAFT_CORE_FACE_CULLING_KERNEL
+
+#include <array>
+#include <cstdint>
+
+namespace plaincraft_core
+{
+    // Visible faces of a 16x16x16 section computed a whole x-row at a time from occupancy bitmasks.
+    // The AVX2 (8 rows) and SSE4.2 (4 rows) paths do the same shifts and and-nots as the scalar one.
+    class FaceCullingKernel final
+    {
+    public:
+        static constexpr uint32_t size = 16;
+        static constexpr uint32_t padded_size = size + 2;
+        static constexpr uint32_t faces_count = 6;
+
+        struct Occupancy
+        {
+            // Non-air blocks, bit x of solid[y * size + z]
+            alignas(32) std::array<uint32_t, size * size> solid;
+
+            // Opaque blocks including the layer around the section, bit x + 1 of opaque[(y + 1) * padded_size + z + 1]
+            alignas(32) std::array<uint32_t, padded_size * padded_size> opaque;
+        };
+
+        // Visible faces in BlockFace order, bit x of faces[face][y * size + z]
+        using FaceMasks = std::array<std::array<uint32_t, size * size>, faces_count>;
+
+        static void CullFaces(const Occupancy &occupancy, FaceMasks &faces);
+
+        static const char *GetInstructionSet();
+    };
+}
+
+#endif // PLAINCRAFT_CORE_FACE_CULLING_KERNEL
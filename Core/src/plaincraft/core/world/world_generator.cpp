@@ -28,6 +28,7 @@ SOFTWARE.
 #include <thread>
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
 
 namespace plaincraft_core
 {
@@ -41,93 +42,134 @@ namespace plaincraft_core
           origin_entity_(origin_entity),
           chunks_processor_(std::move(world_generator), std::move(world_optimizer), scene, ChunksProcessor::Metric(origin_entity))
     {
-        ReloadGrid();
+        MoveWindow();
     }
 
     void WorldGenerator::OnLoopFrameTick(float delta_time)
     {
         auto origin_position = origin_entity_->GetPhysicsObject()->position;
 
-        const auto &lower_chunk = map_->grid_[Map::render_radius - 1][Map::render_radius - 1];
-        const auto &higher_chunk = map_->grid_[Map::render_radius][Map::render_radius];
-        int32_t lower_boundary_x = lower_chunk->GetPositionX() * Chunk::chunk_size;
-        int32_t lower_boundary_z = lower_chunk->GetPositionZ() * Chunk::chunk_size;
-        int32_t higher_boundary_x = (higher_chunk->GetPositionX() + 1) * Chunk::chunk_size;
-        int32_t higher_boundary_z = (higher_chunk->GetPositionZ() + 1) * Chunk::chunk_size;
+        int32_t lower_boundary_x = (map_->GetStartX() + Map::render_radius - 1) * Chunk::chunk_size;
+        int32_t lower_boundary_z = (map_->GetStartZ() + Map::render_radius - 1) * Chunk::chunk_size;
+        int32_t higher_boundary_x = (map_->GetStartX() + Map::render_radius + 1) * Chunk::chunk_size;
+        int32_t higher_boundary_z = (map_->GetStartZ() + Map::render_radius + 1) * Chunk::chunk_size;
 
         if (origin_position.x < static_cast<float>(lower_boundary_x) || origin_position.z < static_cast<float>(lower_boundary_z) || origin_position.x > static_cast<float>(higher_boundary_x) || origin_position.z > static_cast<float>(higher_boundary_z))
         {
-            chunks_processor_.stop_processing = true;
-            if (chunks_processor_.current_to_create_ == nullptr && chunks_processor_.current_to_dispose_ == nullptr)
-            {
-                ReloadGrid();
-            }
+            MoveWindow();
         }
-        else
+
+        chunks_processor_.UpdateLevelsOfDetail();
+
+        Log();
+    }
+
+    BlockId WorldGenerator::GetBlock(int32_t x, int32_t y, int32_t z) const
+    {
+        return map_->GetBlock(x, y, z);
+    }
+
+    bool WorldGenerator::SetBlock(int32_t x, int32_t y, int32_t z, BlockId block_id)
+    {
+        auto edited_chunks = map_->SetBlock(x, y, z, block_id);
+        for (auto &chunk : edited_chunks)
         {
-            chunks_processor_.stop_processing = false;
+            chunks_processor_.RemeshChunk(chunk);
         }
+
+        return !edited_chunks.empty();
     }
 
-    void WorldGenerator::ReloadGrid()
+    void WorldGenerator::MoveWindow()
     {
         auto origin_position = origin_entity_->GetPhysicsObject()->position / static_cast<float>(Chunk::chunk_size);
 
         int32_t start_x = static_cast<int32_t>(origin_position.x) - Map::render_radius;
         int32_t start_z = static_cast<int32_t>(origin_position.z) - Map::render_radius;
 
-        int32_t old_grid_start_x, old_grid_start_z;
-        auto &current_grid = map_->grid_;
-
-        if (map_->is_initialized_)
+        if (!map_->IsInitialized())
         {
-            old_grid_start_x = current_grid[0][0]->GetPositionX();
-            old_grid_start_z = current_grid[0][0]->GetPositionZ();
+            map_->SetStart(start_x, start_z);
+            for (int32_t x = start_x; x < start_x + static_cast<int32_t>(Map::render_diameter); ++x)
+            {
+                for (int32_t z = start_z; z < start_z + static_cast<int32_t>(Map::render_diameter); ++z)
+                {
+                    map_->SetChunk(x, z, chunks_processor_.RequestChunk(x, z));
+                }
+            }
+            return;
         }
 
-        auto current_x = start_x;
-        auto current_z = start_z;
+        auto old_start_x = map_->GetStartX();
+        auto old_start_z = map_->GetStartZ();
 
-        Map::ChunksGrid new_grid;
-        new_grid = Map::ChunksGrid(Map::render_diameter);
-        for (auto &row : new_grid)
-        {
-            row = Map::ChunksRow(Map::render_diameter);
-        }
+        // Only the rows and columns that left the window are released and only the newly exposed ones requested
+        ForEachChunkOutside(old_start_x, old_start_z, start_x, start_z, [&](int32_t x, int32_t z)
+                            {
+                                auto chunk = map_->GetChunk(x, z);
+                                if (chunk != nullptr)
+                                {
+                                    chunks_processor_.RejectChunk(chunk);
+                                }
+                                map_->SetChunk(x, z, nullptr); });
 
-        for (auto &row : new_grid)
-        {
-            current_z = start_z;
+        map_->SetStart(start_x, start_z);
+
+        ForEachChunkOutside(start_x, start_z, old_start_x, old_start_z, [&](int32_t x, int32_t z)
+                            { map_->SetChunk(x, z, chunks_processor_.RequestChunk(x, z)); });
+    }
+
+    void WorldGenerator::ForEachChunkOutside(int32_t window_x, int32_t window_z, int32_t other_window_x, int32_t other_window_z, const std::function<void(int32_t, int32_t)> &callback)
+    {
+        constexpr auto diameter = static_cast<int32_t>(Map::render_diameter);
 
-            for (auto &chunk : row)
+        for (int32_t x = window_x; x < window_x + diameter; ++x)
+        {
+            if (x < other_window_x || x >= other_window_x + diameter)
             {
-                // Try to reuse chunk from the old grid
-                if (map_->is_initialized_ && current_x < old_grid_start_x + static_cast<int32_t>(Map::render_diameter) && current_x >= old_grid_start_x && current_z < old_grid_start_z + static_cast<int32_t>(Map::render_diameter) && current_z >= old_grid_start_z)
-                {
-                    chunk = std::move(current_grid[current_x - old_grid_start_x][current_z - old_grid_start_z]);
-                }
-                else
+                for (int32_t z = window_z; z < window_z + diameter; ++z)
                 {
-                    chunk = chunks_processor_.RequestChunk(current_x, current_z);
+                    callback(x, z);
                 }
-                ++current_z;
+                continue;
             }
 
-            ++current_x;
-        }
+            for (int32_t z = window_z; z < std::min(window_z + diameter, other_window_z); ++z)
+            {
+                callback(x, z);
+            }
 
-        for (auto &row : current_grid)
-        {
-            for (auto &chunk : row)
+            for (int32_t z = std::max(window_z, other_window_z + diameter); z < window_z + diameter; ++z)
             {
-                if (chunk != nullptr)
-                {
-                    chunks_processor_.RejectChunk(chunk);
-                }
+                callback(x, z);
             }
         }
+    }
+
+    void WorldGenerator::Log()
+    {
+        auto &world_optimizer = chunks_processor_.GetWorldOptimizer();
+        auto statistics = world_optimizer.GetStatistics();
+        if (statistics.chunks_count == 0)
+        {
+            return;
+        }
+
+        const char *meshing_mode = world_optimizer.GetMeshingMode() == MeshingMode::Greedy ? "greedy" : "naive";
+        char buffer[128];
+        std::snprintf(buffer, sizeof(buffer), "%s: %llu vertices, %llu indices, %llu bytes",
+                      meshing_mode,
+                      static_cast<unsigned long long>(statistics.vertices_count / statistics.chunks_count),
+                      static_cast<unsigned long long>(statistics.indices_count / statistics.chunks_count),
+                      static_cast<unsigned long long>(statistics.upload_bytes / statistics.chunks_count));
+        LOGVALUE("chunk mesh average", buffer);
 
-        map_->grid_ = std::move(new_grid);
-        map_->is_initialized_ = true;
+        if (statistics.culling_nanoseconds > 0)
+        {
+            std::snprintf(buffer, sizeof(buffer), "%.1f Mvoxels/s (%s)",
+                          static_cast<double>(statistics.culled_voxels_count) * 1e3 / static_cast<double>(statistics.culling_nanoseconds),
+                          FaceCullingKernel::GetInstructionSet());
+            LOGVALUE("face culling", buffer);
+        }
     }
 }
\ No newline at end of file
@@ -57,8 +57,12 @@ namespace plaincraft_core
 
         void OnLoopFrameTick(float delta_time);
 
+        BlockId GetBlock(int32_t x, int32_t y, int32_t z) const;
+        bool SetBlock(int32_t x, int32_t y, int32_t z, BlockId block_id);
+
     private:
-        void ReloadGrid();
+        void MoveWindow();
+        static void ForEachChunkOutside(int32_t window_x, int32_t window_z, int32_t other_window_x, int32_t other_window_z, const std::function<void(int32_t, int32_t)> &callback);
 
         void Log();
     };
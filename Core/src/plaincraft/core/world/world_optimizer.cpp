@@ -30,118 +30,96 @@ namespace plaincraft_core
 {
     WorldOptimizer::WorldOptimizer(std::shared_ptr<Map> map,
                                    AssetsManager &assets_manager,
-                                   ModelsFactory &models_factory)
-        : map_(map), assets_manager_(assets_manager), models_factory_(models_factory)
+                                   ModelsFactory &models_factory,
+                                   MeshingMode meshing_mode,
+                                   MeshingBackend meshing_backend)
+        : map_(map), assets_manager_(assets_manager), models_factory_(models_factory), chunk_mesher_(meshing_mode, meshing_backend)
     {
     }
 
-    void WorldOptimizer::OptimizeChunk(Chunk &chunk)
+    bool WorldOptimizer::OptimizeChunk(Chunk &chunk, const CancellationToken &cancellation_token)
     {
-        std::vector<Vertex> vertices;
-        std::vector<uint32_t> indices;
+        auto mesh = MeshChunk(chunk, cancellation_token);
+        if (mesh == nullptr)
+        {
+            return false;
+        }
+
+        return UploadChunk(chunk, mesh, cancellation_token);
+    }
+
+    std::shared_ptr<ChunkMesh> WorldOptimizer::MeshChunk(const Chunk &chunk, const CancellationToken &cancellation_token, Chunk::SectionsMask sections_mask, uint32_t lod_level)
+    {
+        // Coarse meshes never look across the chunk borders
+        auto neighbors = lod_level > 0 ? ChunkNeighbors() : GetNeighbors(chunk);
+        return chunk_mesher_.MeshChunk(chunk, neighbors, cancellation_token, sections_mask, lod_level);
+    }
 
+    bool WorldOptimizer::UploadChunk(Chunk &chunk, std::shared_ptr<ChunkMesh const> mesh, const CancellationToken &cancellation_token)
+    {
         float r = static_cast<float>(1.f);
         float g = static_cast<float>(1.f);
         float b = static_cast<float>(1.f);
         auto color = glm::vec3(r, g, b);
 
-        for (auto x = 0; x < Chunk::chunk_size; ++x)
+        // Remeshed chunks are already in the scene, only their model gets replaced
+        if (chunk.GetDrawable()->GetModel() == nullptr)
         {
-            for (auto y = 0; y < Chunk::chunk_height; ++y)
-            {
-                for (auto z = 0; z < Chunk::chunk_size; ++z)
-                {
-                    std::set<Cube::Faces> visible_faces;
-                    auto block = chunk.blocks_[x][y][z];
-
-                    if (block == nullptr)
-                    {
-                        continue;
-                    }
-
-                    auto txt_u_factor = 16.0f / 384.0f;
-                    auto txt_v_factor = 16.0f / 544.0f;
-                    auto &text_cood = block->GetTextureCoordinates();
-                    auto &[top, bottom, left, right, front, back] = text_cood;
-
-                    // X axis check
-                    if (x == 0 || (x > 0 && chunk.blocks_[x - 1][y][z] == nullptr))
-                    {
-                        vertices.push_back({{x - 0.5f, y - 0.5f, z - 0.5f}, {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {left.first * txt_u_factor, (left.second + 1) * txt_v_factor}});
-                        vertices.push_back({{x - 0.5f, y + 0.5f, z - 0.5f}, {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {left.first * txt_u_factor, left.second * txt_v_factor}});
-                        vertices.push_back({{x - 0.5f, y + 0.5f, z + 0.5f}, {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {(left.first + 1) * txt_u_factor, left.second * txt_v_factor}});
-                        vertices.push_back({{x - 0.5f, y - 0.5f, z + 0.5f}, {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {(left.first + 1) * txt_u_factor, (left.second + 1) * txt_v_factor}});
-                    }
-
-                    if ((x == Chunk::chunk_size - 1) || x < Chunk::chunk_size - 1 && chunk.blocks_[x + 1][y][z] == nullptr)
-                    {
-                        vertices.push_back({{x + 0.5f, y - 0.5f, z - 0.5f}, {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {right.first * txt_u_factor, (right.second + 1) * txt_v_factor}});
-                        vertices.push_back({{x + 0.5f, y - 0.5f, z + 0.5f}, {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {(right.first + 1) * txt_u_factor, (right.second + 1) * txt_v_factor}});
-                        vertices.push_back({{x + 0.5f, y + 0.5f, z + 0.5f}, {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {(right.first + 1) * txt_u_factor, right.second * txt_v_factor}});
-                        vertices.push_back({{x + 0.5f, y + 0.5f, z - 0.5f}, {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {right.first * txt_u_factor, right.second * txt_v_factor}});
-                    }
-
-                    // Y axis check
-                    if (y > 0 && chunk.blocks_[x][y - 1][z] == nullptr)
-                    {
-                        vertices.push_back({{x - 0.5f, y - 0.5f, z - 0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.5f}});
-                        vertices.push_back({{x - 0.5f, y - 0.5f, z + 0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.5f, 0.5f}});
-                        vertices.push_back({{x + 0.5f, y - 0.5f, z + 0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.5f, 1.0f}});
-                        vertices.push_back({{x + 0.5f, y - 0.5f, z - 0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f}});
-                    }
-                    if (y < Chunk::chunk_height - 1 && chunk.blocks_[x][y + 1][z] == nullptr)
-                    {
-                        vertices.push_back({{x - 0.5f, y + 0.5f, z - 0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {top.first * txt_u_factor, top.second * txt_v_factor}});
-                        vertices.push_back({{x + 0.5f, y + 0.5f, z - 0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {(top.first + 1) * txt_u_factor, top.second * txt_v_factor}});
-                        vertices.push_back({{x + 0.5f, y + 0.5f, z + 0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {(top.first + 1) * txt_u_factor, (top.second + 1) * txt_v_factor}});
-                        vertices.push_back({{x - 0.5f, y + 0.5f, z + 0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {top.first * txt_u_factor, (top.second + 1) * txt_v_factor}});
-                    }
-
-                    // Z axis check
-                    if (z == 0 || (z > 0 && chunk.blocks_[x][y][z - 1] == nullptr))
-                    {
-                        vertices.push_back({{x - 0.5f, y - 0.5f, z - 0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}, {front.first * txt_u_factor, (front.second + 1) * txt_v_factor}});
-                        vertices.push_back({{x + 0.5f, y - 0.5f, z - 0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}, {(front.first + 1) * txt_u_factor, (front.second + 1) * txt_v_factor}});
-                        vertices.push_back({{x + 0.5f, y + 0.5f, z - 0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}, {(front.first + 1) * txt_u_factor, front.second * txt_v_factor}});
-                        vertices.push_back({{x - 0.5f, y + 0.5f, z - 0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}, {front.first * txt_u_factor, front.second * txt_v_factor}});
-                    }
-
-                    if (z == Chunk::chunk_size - 1 || (z < Chunk::chunk_size - 1 && chunk.blocks_[x][y][z + 1] == nullptr))
-                    {
-                        vertices.push_back({{x - 0.5f, y - 0.5f, z + 0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}, {back.first * txt_u_factor, (back.second + 1) * txt_v_factor}});
-                        vertices.push_back({{x - 0.5f, y + 0.5f, z + 0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}, {back.first * txt_u_factor, back.second * txt_v_factor}});
-                        vertices.push_back({{x + 0.5f, y + 0.5f, z + 0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}, {(back.first + 1) * txt_u_factor, back.second * txt_v_factor}});
-                        vertices.push_back({{x + 0.5f, y - 0.5f, z + 0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}, {(back.first + 1) * txt_u_factor, (back.second + 1) * txt_v_factor}});
-                    }
-                }
-            }
+            auto drawable_position_x = Chunk::chunk_size * static_cast<float>(chunk.pos_x_);
+            auto drawable_position_z = Chunk::chunk_size * static_cast<float>(chunk.pos_z_);
+            chunk.GetDrawable()->SetPosition(Vector3d(drawable_position_x, 0, drawable_position_z));
+            // Blocks are centered on their coordinates so the geometry spans half a block below the chunk origin
+            chunk.GetDrawable()->SetBounds(Vector3d(-0.5f, -0.5f, -0.5f), Vector3d(Chunk::chunk_size - 0.5f, Chunk::chunk_height - 0.5f, Chunk::chunk_size - 0.5f));
+            chunk.GetDrawable()->SetColor(color);
+            chunk.GetDrawable()->SetTexture(assets_manager_.GetTexture("blocks"));
         }
 
-        for (auto i = 0; i < vertices.size() / 4; ++i)
+        std::unique_lock lk(models_factory_mutex_);
+        if (cancellation_token.IsCancelled())
         {
-            indices.push_back(2 + 4 * i);
-            indices.push_back(1 + 4 * i);
-            indices.push_back(0 + 4 * i);
-
-            indices.push_back(2 + 4 * i);
-            indices.push_back(0 + 4 * i);
-            indices.push_back(3 + 4 * i);
+            return false;
         }
 
-        auto mesh = std::make_shared<plaincraft_render_engine::Mesh>(std::move(vertices), std::move(indices));
+        auto model = models_factory_.CreateChunkModel(mesh, chunk.GetDrawable()->GetModel());
+        lk.unlock();
 
-        auto drawable_position_x = Chunk::chunk_size * static_cast<float>(chunk.pos_x_);
-        auto drawable_position_z = Chunk::chunk_size * static_cast<float>(chunk.pos_z_);
-        chunk.GetDrawable()->SetPosition(Vector3d(drawable_position_x, 0, drawable_position_z));
-        chunk.GetDrawable()->SetColor(color);
-
-        auto model = models_factory_.CreateModel(mesh);
-        auto blocks_texture = assets_manager_.GetTexture("blocks");
         chunk.GetDrawable()->SetModel(std::move(model));
-        chunk.GetDrawable()->SetTexture(blocks_texture);
+
+        return true;
     }
 
     void WorldOptimizer::DisposeChunk(Chunk &chunk)
     {
     }
-}
\ No newline at end of file
+
+    void WorldOptimizer::SetMeshingMode(MeshingMode meshing_mode)
+    {
+        chunk_mesher_.SetMeshingMode(meshing_mode);
+    }
+
+    MeshingMode WorldOptimizer::GetMeshingMode() const
+    {
+        return chunk_mesher_.GetMeshingMode();
+    }
+
+    MeshingStatistics WorldOptimizer::GetStatistics() const
+    {
+        return chunk_mesher_.GetStatistics();
+    }
+
+    void WorldOptimizer::ResetStatistics()
+    {
+        chunk_mesher_.ResetStatistics();
+    }
+
+    ChunkNeighbors WorldOptimizer::GetNeighbors(const Chunk &chunk) const
+    {
+        auto get_neighbor = [this, &chunk](int32_t offset_x, int32_t offset_z) -> std::shared_ptr<Chunk>
+        {
+            auto neighbor = map_->GetChunk(chunk.pos_x_ + offset_x, chunk.pos_z_ + offset_z);
+            return neighbor != nullptr && neighbor->initialized_ ? neighbor : nullptr;
+        };
+
+        return ChunkNeighbors{get_neighbor(-1, 0), get_neighbor(1, 0), get_neighbor(0, -1), get_neighbor(0, 1)};
+    }
+}
@@ -30,8 +30,8 @@ SOFTWARE.
 #include "../entities/map/map.hpp"
 #include "../entities/map/chunk.hpp"
 #include "../assets/assets_manager.hpp"
-#include <optional>
-#include <functional>
+#include "chunk_mesher.hpp"
+#include <mutex>
 #include <plaincraft_common.hpp>
 #include <plaincraft_render_engine.hpp>
 
@@ -41,18 +41,40 @@ namespace plaincraft_core
 
     class WorldOptimizer
     {
+    public:
+        static constexpr uint32_t lod_levels_count = ChunkMesher::lod_levels_count;
+
+    private:
         std::shared_ptr<Map> map_;
         AssetsManager &assets_manager_;
         ModelsFactory &models_factory_;
+        std::mutex models_factory_mutex_;
+
+        ChunkMesher chunk_mesher_;
 
     public:
         WorldOptimizer(std::shared_ptr<Map> map,
                        AssetsManager &assets_manager,
-                       ModelsFactory &models_factory);
+                       ModelsFactory &models_factory,
+                       MeshingMode meshing_mode = MeshingMode::Greedy,
+                       MeshingBackend meshing_backend = MeshingBackend::Cpu);
+
+        bool OptimizeChunk(Chunk &chunk, const CancellationToken &cancellation_token = CancellationToken());
 
-        void OptimizeChunk(Chunk &chunk);
+        // Meshing only builds vertex data and is safe to run on any thread, the upload creates the GPU model
+        std::shared_ptr<ChunkMesh> MeshChunk(const Chunk &chunk, const CancellationToken &cancellation_token = CancellationToken(), Chunk::SectionsMask sections_mask = Chunk::all_sections_mask, uint32_t lod_level = 0);
+        bool UploadChunk(Chunk &chunk, std::shared_ptr<ChunkMesh const> mesh, const CancellationToken &cancellation_token = CancellationToken());
         void DisposeChunk(Chunk &chunk);
+
+        void SetMeshingMode(MeshingMode meshing_mode);
+        MeshingMode GetMeshingMode() const;
+
+        MeshingStatistics GetStatistics() const;
+        void ResetStatistics();
+
+    private:
+        ChunkNeighbors GetNeighbors(const Chunk &chunk) const;
     };
 }
 
-#endif // PLAINCRAFT_CORE_WORLD_OPTIMIZER
\ No newline at end of file
+#endif // PLAINCRAFT_CORE_WORLD_OPTIMIZER
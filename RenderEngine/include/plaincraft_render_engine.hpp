@@ -47,13 +47,17 @@ SOFTWARE.
 #include "../src/plaincraft/render_engine/gui/gui_renderer.hpp"
 #include "../src/plaincraft/render_engine/gui/gui_widget.hpp"
 
+#include "../src/plaincraft/render_engine/scene/objects/chunk_mesh.hpp"
+#include "../src/plaincraft/render_engine/scene/objects/chunk_voxels.hpp"
 #include "../src/plaincraft/render_engine/scene/objects/cube.hpp"
 #include "../src/plaincraft/render_engine/scene/objects/no_draw.hpp"
 #include "../src/plaincraft/render_engine/scene/objects/mesh.hpp"
 #include "../src/plaincraft/render_engine/scene/scene_renderer.hpp"
 #include "../src/plaincraft/render_engine/scene/vertex.hpp"
+#include "../src/plaincraft/render_engine/scene/chunk_vertex.hpp"
 #include "../src/plaincraft/render_engine/scene/mvp_matrix.hpp"
 #include "../src/plaincraft/render_engine/scene/drawable.hpp"
+#include "../src/plaincraft/render_engine/scene/frustum_culling_kernel.hpp"
 
 #include "../src/plaincraft/render_engine/window/window.hpp"
 
@@ -28,12 +28,16 @@ SOFTWARE.
 #define PLAINCRAFT_RENDER_ENGINE_MODELS_FACTORY
 
 #include "model.hpp"
+#include "../scene/objects/chunk_mesh.hpp"
 #include <memory>
 
 namespace plaincraft_render_engine {
     class ModelsFactory {
         public:
             virtual std::unique_ptr<Model> CreateModel(std::shared_ptr<Mesh const> mesh) = 0;
+            // Sections not updated by the mesh are taken over from the previous model of the chunk, if any.
+            // Meshes made of voxels are meshed on the device and throw where the backend has no device meshing.
+            virtual std::unique_ptr<Model> CreateChunkModel(std::shared_ptr<ChunkMesh const> mesh, std::shared_ptr<Model> previous_model) = 0;
     };
 }
 
@@ -24,24 +24,15 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
-#include "dirt.hpp"
+#include "chunk_vertex.hpp"
 
-namespace plaincraft_core
+namespace plaincraft_render_engine
 {
-    Dirt::Dirt() {
-        
+    ChunkVertex ChunkVertex::Pack(uint32_t x, uint32_t y, uint32_t z, uint32_t normal_index, uint32_t u, uint32_t v, uint32_t tile_column, uint32_t tile_row)
+    {
+        ChunkVertex result;
+        result.position_normal_uv = (x & 0x1f) | ((y & 0x7f) << 5) | ((z & 0x1f) << 12) | ((normal_index & 0x7) << 17) | ((u & 0x1f) << 20) | ((v & 0x1f) << 25);
+        result.tile = (tile_column & 0xff) | ((tile_row & 0xff) << 8);
+        return result;
     }
-
-    const Block::TextureCoordinates& Dirt::GetTextureCoordinates() const {
-        static Block::TextureCoordinates text_cood {
-            std::make_pair(0, 0),
-            std::make_pair(2, 0),
-            std::make_pair(3, 0),
-            std::make_pair(3, 0),
-            std::make_pair(3, 0),
-            std::make_pair(3, 0)
-        };
-
-        return text_cood;
-    }
-}
\ No newline at end of file
+}
@@ -0,0 +1,53 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_RENDER_ENGINE_CHUNK_VERTEX
+#define PLAINCRAFT_RENDER_ENGINE_CHUNK_VERTEX
+
+#include <cstdint>
+
+namespace plaincraft_render_engine
+{
+	// Chunk vertex packed into two words, decoded by the chunk vertex shader
+	//   position_normal_uv: x [0, 5), y [5, 12), z [12, 17), normal index [17, 20), u [20, 25), v [25, 30)
+	//   tile: atlas column [0, 8), atlas row [8, 16)
+	// Positions are block corners in chunk space, texture coordinates are counted in blocks
+	struct ChunkVertex
+	{
+		uint32_t position_normal_uv;
+		uint32_t tile;
+
+		static constexpr uint32_t max_horizontal_position = 31;
+		static constexpr uint32_t max_vertical_position = 127;
+		static constexpr uint32_t max_texture_coordinate = 31;
+
+		static ChunkVertex Pack(uint32_t x, uint32_t y, uint32_t z, uint32_t normal_index, uint32_t u, uint32_t v, uint32_t tile_column, uint32_t tile_row);
+	};
+
+	static_assert(sizeof(ChunkVertex) == 8, "Chunk vertex is expected to fit in 8 bytes");
+}
+
+#endif // PLAINCRAFT_RENDER_ENGINE_CHUNK_VERTEX
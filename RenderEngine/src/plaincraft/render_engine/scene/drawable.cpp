@@ -31,11 +31,13 @@ namespace plaincraft_render_engine
 {
 	void Drawable::SetModel(std::shared_ptr<Model> model)
 	{
-		model_ = model;
+		std::lock_guard lk(model_mutex_);
+		model_ = std::move(model);
 	}
 
 	std::shared_ptr<Model> Drawable::GetModel() const
 	{
+		std::lock_guard lk(model_mutex_);
 		return model_;
 	}
 
@@ -92,6 +94,28 @@ namespace plaincraft_render_engine
 		return color_;
 	}
 
+	void Drawable::SetBounds(Vector3d min, Vector3d max)
+	{
+		bounds_min_ = min;
+		bounds_max_ = max;
+		has_bounds_ = true;
+	}
+
+	bool Drawable::HasBounds() const
+	{
+		return has_bounds_;
+	}
+
+	Vector3d Drawable::GetBoundsMin() const
+	{
+		return bounds_min_;
+	}
+
+	Vector3d Drawable::GetBoundsMax() const
+	{
+		return bounds_max_;
+	}
+
 	glm::mat4 Drawable::GetModelMatrix() const
 	{
 		return model_matrix_;
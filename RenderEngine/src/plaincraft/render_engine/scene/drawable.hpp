@@ -28,18 +28,25 @@ SOFTWARE.
 #define PLAINCRAFT_RENDER_ENGINE_DRAWABLE
 #include "../common.hpp"
 #include "../models/model.hpp"
+#include <mutex>
 
 namespace plaincraft_render_engine
 {
 	class Drawable
 	{
 	private:
+		// Models can be replaced from worker threads while the renderer reads them
 		std::shared_ptr<Model> model_;
+		mutable std::mutex model_mutex_;
 		std::shared_ptr<Texture> texture_;
 		Vector3d position_;
 		Vector3d color_;
 		Quaternion rotation_;
 		float scale_ = 1.0f;
+
+		bool has_bounds_ = false;
+		Vector3d bounds_min_;
+		Vector3d bounds_max_;
 		
 		glm::mat4 model_matrix_;
 
@@ -62,6 +69,13 @@ namespace plaincraft_render_engine
 		void SetColor(Vector3d color);
 		Vector3d GetColor() const;
 
+		// Axis-aligned box relative to the position, rotation and scale are not applied to it.
+		// Drawables without bounds are never culled.
+		void SetBounds(Vector3d min, Vector3d max);
+		bool HasBounds() const;
+		Vector3d GetBoundsMin() const;
+		Vector3d GetBoundsMax() const;
+
 		glm::mat4 GetModelMatrix() const;
 
 	private:
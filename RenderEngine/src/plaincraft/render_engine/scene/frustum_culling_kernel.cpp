@@ -0,0 +1,162 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "frustum_culling_kernel.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PLAINCRAFT_FRUSTUM_AVX2
+#elif defined(__SSE4_2__) || defined(PLAINCRAFT_SIMD_SSE42)
+#include <nmmintrin.h>
+#define PLAINCRAFT_FRUSTUM_SSE42
+#endif
+
+namespace plaincraft_render_engine
+{
+	void FrustumCullingKernel::BoundingBoxes::Add(const Vector3d &min, const Vector3d &max)
+	{
+		min_x_.push_back(min.x);
+		min_y_.push_back(min.y);
+		min_z_.push_back(min.z);
+		max_x_.push_back(max.x);
+		max_y_.push_back(max.y);
+		max_z_.push_back(max.z);
+	}
+
+	void FrustumCullingKernel::BoundingBoxes::Clear()
+	{
+		min_x_.clear();
+		min_y_.clear();
+		min_z_.clear();
+		max_x_.clear();
+		max_y_.clear();
+		max_z_.clear();
+	}
+
+	FrustumCullingKernel::Planes FrustumCullingKernel::ExtractPlanes(const glm::mat4 &view_projection)
+	{
+		auto row = [&view_projection](int32_t index)
+		{
+			return glm::vec4(view_projection[0][index], view_projection[1][index], view_projection[2][index], view_projection[3][index]);
+		};
+
+		auto x = row(0);
+		auto y = row(1);
+		auto z = row(2);
+		auto w = row(3);
+
+		return Planes{w + x, w - x, w + y, w - y, w + z, w - z};
+	}
+
+	uint32_t FrustumCullingKernel::CullBoxes(const Planes &planes, const BoundingBoxes &boxes, std::vector<uint8_t> &visible)
+	{
+		auto count = boxes.GetCount();
+		visible.resize(count);
+
+		// The corner of a box furthest along the plane normal, the box is outside when even that one is behind the plane
+		std::array<const float *, planes_count> positive_x;
+		std::array<const float *, planes_count> positive_y;
+		std::array<const float *, planes_count> positive_z;
+		for (uint32_t p = 0; p < planes_count; ++p)
+		{
+			positive_x[p] = planes[p].x >= 0.0f ? boxes.max_x_.data() : boxes.min_x_.data();
+			positive_y[p] = planes[p].y >= 0.0f ? boxes.max_y_.data() : boxes.min_y_.data();
+			positive_z[p] = planes[p].z >= 0.0f ? boxes.max_z_.data() : boxes.min_z_.data();
+		}
+
+		size_t i = 0;
+		uint32_t visible_count = 0;
+
+#if defined(PLAINCRAFT_FRUSTUM_AVX2)
+		for (; i + 8 <= count; i += 8)
+		{
+			auto inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (uint32_t p = 0; p < planes_count; ++p)
+			{
+				auto distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes[p].x), _mm256_loadu_ps(positive_x[p] + i)),
+											  _mm256_mul_ps(_mm256_set1_ps(planes[p].y), _mm256_loadu_ps(positive_y[p] + i)));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes[p].z), _mm256_loadu_ps(positive_z[p] + i)));
+				distance = _mm256_add_ps(distance, _mm256_set1_ps(planes[p].w));
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+			}
+
+			auto mask = _mm256_movemask_ps(inside);
+			for (uint32_t lane = 0; lane < 8; ++lane)
+			{
+				visible[i + lane] = (mask >> lane) & 1;
+			}
+			visible_count += _mm_popcnt_u32(mask);
+		}
+#elif defined(PLAINCRAFT_FRUSTUM_SSE42)
+		for (; i + 4 <= count; i += 4)
+		{
+			auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (uint32_t p = 0; p < planes_count; ++p)
+			{
+				auto distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].x), _mm_loadu_ps(positive_x[p] + i)),
+										   _mm_mul_ps(_mm_set1_ps(planes[p].y), _mm_loadu_ps(positive_y[p] + i)));
+				distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes[p].z), _mm_loadu_ps(positive_z[p] + i)));
+				distance = _mm_add_ps(distance, _mm_set1_ps(planes[p].w));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+			}
+
+			auto mask = _mm_movemask_ps(inside);
+			for (uint32_t lane = 0; lane < 4; ++lane)
+			{
+				visible[i + lane] = (mask >> lane) & 1;
+			}
+			visible_count += _mm_popcnt_u32(mask);
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			auto inside = true;
+			for (uint32_t p = 0; p < planes_count && inside; ++p)
+			{
+				auto distance = planes[p].x * positive_x[p][i] + planes[p].y * positive_y[p][i];
+				distance = distance + planes[p].z * positive_z[p][i];
+				inside = distance + planes[p].w >= 0.0f;
+			}
+
+			visible[i] = inside ? 1 : 0;
+			visible_count += visible[i];
+		}
+
+		return visible_count;
+	}
+
+	const char *FrustumCullingKernel::GetInstructionSet()
+	{
+#if defined(PLAINCRAFT_FRUSTUM_AVX2)
+		return "AVX2";
+#elif defined(PLAINCRAFT_FRUSTUM_SSE42)
+		return "SSE4.2";
+#else
+		return "None";
+#endif
+	}
+}
@@ -0,0 +1,80 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_RENDER_ENGINE_FRUSTUM_CULLING_KERNEL
+#define PLAINCRAFT_RENDER_ENGINE_FRUSTUM_CULLING_KERNEL
+
+#include "../common.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace plaincraft_render_engine
+{
+	// Visibility of axis-aligned boxes against the view frustum, each plane is tested against a whole batch of boxes.
+	// The AVX2 (8 boxes) and SSE4.2 (4 boxes) paths do the same positive vertex test as the scalar one.
+	class FrustumCullingKernel final
+	{
+	public:
+		static constexpr uint32_t planes_count = 6;
+
+		// Points with dot(plane.xyz, point) + plane.w >= 0 are on the inner side of a plane
+		using Planes = std::array<glm::vec4, planes_count>;
+
+		// World space boxes stored per component so a batch of them loads into one register
+		class BoundingBoxes
+		{
+		private:
+			std::vector<float> min_x_;
+			std::vector<float> min_y_;
+			std::vector<float> min_z_;
+			std::vector<float> max_x_;
+			std::vector<float> max_y_;
+			std::vector<float> max_z_;
+
+		public:
+			void Add(const Vector3d &min, const Vector3d &max);
+			void Clear();
+
+			size_t GetCount() const
+			{
+				return min_x_.size();
+			}
+
+			friend class FrustumCullingKernel;
+		};
+
+		// Planes of a view projection matrix with OpenGL or Vulkan depth range, for the latter the near plane is conservative
+		static Planes ExtractPlanes(const glm::mat4 &view_projection);
+
+		// Sets visible[i] to 1 when boxes[i] intersects the frustum and returns the number of visible boxes
+		static uint32_t CullBoxes(const Planes &planes, const BoundingBoxes &boxes, std::vector<uint8_t> &visible);
+
+		static const char *GetInstructionSet();
+	};
+}
+
+#endif // PLAINCRAFT_RENDER_ENGINE_FRUSTUM_CULLING_KERNEL
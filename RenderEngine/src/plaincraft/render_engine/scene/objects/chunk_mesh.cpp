@@ -0,0 +1,73 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "chunk_mesh.hpp"
+
+namespace plaincraft_render_engine
+{
+    ChunkMesh::ChunkMesh(std::vector<std::vector<ChunkVertex>> &&sections, uint32_t updated_sections_mask)
+        : sections_(std::move(sections)), updated_sections_mask_(updated_sections_mask)
+    {
+    }
+
+    ChunkMesh::ChunkMesh(std::shared_ptr<ChunkVoxels const> voxels)
+        : updated_sections_mask_(0), voxels_(std::move(voxels))
+    {
+    }
+
+    ChunkMesh::ChunkMesh(ChunkMesh &&other) noexcept
+        : sections_(std::move(other.sections_)), updated_sections_mask_(other.updated_sections_mask_), voxels_(std::move(other.voxels_))
+    {
+    }
+
+    ChunkMesh &ChunkMesh::operator=(ChunkMesh &&other) noexcept
+    {
+        if (&other == this)
+        {
+            return *this;
+        }
+
+        sections_ = std::move(other.sections_);
+        updated_sections_mask_ = other.updated_sections_mask_;
+        voxels_ = std::move(other.voxels_);
+
+        return *this;
+    }
+
+    uint32_t ChunkMesh::GetVerticesCount() const
+    {
+        uint32_t vertices_count = 0;
+        for (uint32_t section_index = 0; section_index < GetSectionsCount(); ++section_index)
+        {
+            if (IsSectionUpdated(section_index))
+            {
+                vertices_count += static_cast<uint32_t>(sections_[section_index].size());
+            }
+        }
+
+        return vertices_count;
+    }
+}
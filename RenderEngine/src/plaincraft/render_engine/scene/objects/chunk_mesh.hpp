@@ -0,0 +1,96 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_RENDER_ENGINE_CHUNK_MESH
+#define PLAINCRAFT_RENDER_ENGINE_CHUNK_MESH
+
+#include "../chunk_vertex.hpp"
+#include "chunk_voxels.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace plaincraft_render_engine
+{
+	// Vertices grouped by chunk section, sections that are not updated keep the geometry of the previous model.
+	// A mesh made of voxels has no vertices yet, its faces are extracted on the device and replace the whole model.
+	class ChunkMesh
+	{
+	private:
+		std::vector<std::vector<ChunkVertex>> sections_;
+		uint32_t updated_sections_mask_;
+		std::shared_ptr<ChunkVoxels const> voxels_;
+
+	public:
+		// Quads are indexed with a shared 2,1,0,2,0,3 pattern instead of per-mesh indices
+		static constexpr uint32_t vertices_per_quad = 4;
+		static constexpr uint32_t indices_per_quad = 6;
+
+		ChunkMesh(std::vector<std::vector<ChunkVertex>> &&sections, uint32_t updated_sections_mask);
+		ChunkMesh(std::shared_ptr<ChunkVoxels const> voxels);
+
+		ChunkMesh(const ChunkMesh &other) = delete;
+		ChunkMesh &operator=(const ChunkMesh &other) = delete;
+
+		ChunkMesh(ChunkMesh &&other) noexcept;
+		ChunkMesh &operator=(ChunkMesh &&other) noexcept;
+
+		uint32_t GetSectionsCount() const
+		{
+			return static_cast<uint32_t>(sections_.size());
+		}
+
+		bool IsSectionUpdated(uint32_t section_index) const
+		{
+			return (updated_sections_mask_ >> section_index) & 1;
+		}
+
+		uint32_t GetUpdatedSectionsMask() const
+		{
+			return updated_sections_mask_;
+		}
+
+		const std::vector<ChunkVertex> &GetSectionVertices(uint32_t section_index) const
+		{
+			return sections_[section_index];
+		}
+
+		const std::shared_ptr<ChunkVoxels const> &GetVoxels() const
+		{
+			return voxels_;
+		}
+
+		uint32_t GetVerticesCount() const;
+
+		uint32_t GetIndicesCount() const
+		{
+			return GetVerticesCount() / vertices_per_quad * indices_per_quad;
+		}
+	};
+}
+
+#endif // PLAINCRAFT_RENDER_ENGINE_CHUNK_MESH
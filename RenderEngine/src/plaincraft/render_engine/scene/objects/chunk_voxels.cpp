@@ -24,18 +24,18 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
-#ifndef PLAINCRAFT_CORE_STONE
-#define PLAINCRAFT_CORE_STONE
+#include "chunk_voxels.hpp"
+#include <stdexcept>
+#include <utility>
 
-#include "./block.hpp"
-
-namespace plaincraft_core 
+namespace plaincraft_render_engine
 {
-    class Stone : public Block
+    ChunkVoxels::ChunkVoxels(std::vector<uint32_t> &&blocks, std::vector<uint32_t> block_table)
+        : blocks_(std::move(blocks)), block_table_(std::move(block_table))
     {
-        public:
-            const TextureCoordinates& GetTextureCoordinates() const override;
-    };
+        if (blocks_.size() != blocks_count / 2 || block_table_.size() % block_table_stride != 0)
+        {
+            throw std::runtime_error("Chunk voxels do not match the padded chunk layout");
+        }
+    }
 }
-
-#endif // PLAINCRAFT_CORE_STONE
\ No newline at end of file
@@ -0,0 +1,75 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_RENDER_ENGINE_CHUNK_VOXELS
+#define PLAINCRAFT_RENDER_ENGINE_CHUNK_VOXELS
+
+#include <cstdint>
+#include <vector>
+
+namespace plaincraft_render_engine
+{
+	// Block ids of a whole chunk for meshing on the device, two 16-bit ids per word.
+	// The chunk is padded with one block of its horizontal neighbors, blocks[(y * padded_size + z + 1) * padded_size + x + 1].
+	// The block table has block_table_stride words per block id: face tiles packed as ChunkVertex::tile, two per word, then the flags.
+	class ChunkVoxels
+	{
+	public:
+		static constexpr uint32_t size = 16;
+		static constexpr uint32_t height = 64;
+		static constexpr uint32_t padded_size = size + 2;
+		static constexpr uint32_t blocks_count = padded_size * padded_size * height;
+		static constexpr uint32_t block_table_stride = 4;
+		static constexpr uint32_t opaque_flag = 1;
+
+	private:
+		std::vector<uint32_t> blocks_;
+		std::vector<uint32_t> block_table_;
+
+	public:
+		ChunkVoxels(std::vector<uint32_t> &&blocks, std::vector<uint32_t> block_table);
+
+		ChunkVoxels(const ChunkVoxels &other) = delete;
+		ChunkVoxels &operator=(const ChunkVoxels &other) = delete;
+
+		const std::vector<uint32_t> &GetBlocks() const
+		{
+			return blocks_;
+		}
+
+		const std::vector<uint32_t> &GetBlockTable() const
+		{
+			return block_table_;
+		}
+
+		static uint32_t GetBlockIndex(uint32_t padded_x, uint32_t y, uint32_t padded_z)
+		{
+			return (y * padded_size + padded_z) * padded_size + padded_x;
+		}
+	};
+}
+
+#endif // PLAINCRAFT_RENDER_ENGINE_CHUNK_VOXELS
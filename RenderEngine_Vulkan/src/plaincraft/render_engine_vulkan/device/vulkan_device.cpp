@@ -27,8 +27,10 @@ SOFTWARE.
 #include "vulkan_device.hpp"
 #include "../utils/queue_family.hpp"
 #include "../utils/validation_layers.hpp"
+#include "../memory/vulkan_upload_manager.hpp"
 #include "../swapchain/vulkan_swapchain.hpp"
 #include <vulkan/vulkan.h>
+#include <algorithm>
 #include <stdexcept>
 #include <set>
 #include <string>
@@ -36,18 +38,24 @@ SOFTWARE.
 namespace plaincraft_render_engine_vulkan
 {
 	VulkanDevice::VulkanDevice(const VulkanInstance &instance, VkSurfaceKHR surface)
+		: headless_(surface == VK_NULL_HANDLE)
 	{
 		PickPhysicalDevice(instance, surface);
 		CreateLogicalDevice(surface);
+		memory_allocator_ = std::make_unique<VulkanMemoryAllocator>(physical_device_, device_);
 		CreateSyncObjects();
 		CreateQueues(surface);
 		CreateCommandPool(surface);
+		upload_manager_ = std::make_unique<VulkanUploadManager>(*this);
 	}
 
 	VulkanDevice::~VulkanDevice()
 	{
+		upload_manager_->WaitIdle();
+		upload_manager_.reset();
 		vkDestroyCommandPool(device_, graphics_command_pool_, nullptr);
 		vkDestroyCommandPool(device_, transfer_command_pool_, nullptr);
+		memory_allocator_.reset();
 		vkDestroyDevice(device_, nullptr);
 	}
 
@@ -64,11 +72,25 @@ namespace plaincraft_render_engine_vulkan
 		std::vector<VkPhysicalDevice> devices(device_count);
 		vkEnumeratePhysicalDevices(instance.GetInstance(), &device_count, devices.data());
 
+		// Discrete GPUs come first, any other device such as a software rasterizer is only a fallback
 		for (const auto &device : devices)
 		{
-			if (IsDeviceSuitable(device, surface))
+			if (!IsDeviceSuitable(device, surface))
+			{
+				continue;
+			}
+
+			VkPhysicalDeviceProperties device_properties;
+			vkGetPhysicalDeviceProperties(device, &device_properties);
+
+			auto is_discrete = device_properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU;
+			if (physical_device_ == VK_NULL_HANDLE || is_discrete)
 			{
 				physical_device_ = device;
+			}
+
+			if (is_discrete)
+			{
 				break;
 			}
 		}
@@ -85,6 +107,10 @@ namespace plaincraft_render_engine_vulkan
 
 		std::vector<VkDeviceQueueCreateInfo> queue_create_infos;
 		std::set<uint32_t> unique_queue_families = {indices.graphics_family.value(), indices.present_family.value()};
+		if (indices.transfer_family.has_value())
+		{
+			unique_queue_families.insert(indices.transfer_family.value());
+		}
 
 		std::vector<float> queue_priorities = {1.0f, 1.0f};
 		for (auto queue_family : unique_queue_families)
@@ -92,21 +118,33 @@ namespace plaincraft_render_engine_vulkan
 			VkDeviceQueueCreateInfo device_queue_create_info{};
 			device_queue_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
 			device_queue_create_info.queueFamilyIndex = queue_family;
-			device_queue_create_info.queueCount = queue_family == indices.graphics_family.value() ? 2 : 1;
+			device_queue_create_info.queueCount = queue_family == indices.graphics_family.value() ? std::min(GetGraphicsQueuesCount(physical_device_, queue_family), 2u) : 1;
 			device_queue_create_info.pQueuePriorities = queue_priorities.data();
 			queue_create_infos.push_back(device_queue_create_info);
 		}
 
+		VkPhysicalDeviceFeatures supported_features;
+		vkGetPhysicalDeviceFeatures(physical_device_, &supported_features);
+		multi_draw_indirect_ = supported_features.multiDrawIndirect && supported_features.drawIndirectFirstInstance;
+
 		VkPhysicalDeviceFeatures device_feauters{};
 		device_feauters.samplerAnisotropy = VK_TRUE;
+		device_feauters.multiDrawIndirect = multi_draw_indirect_ ? VK_TRUE : VK_FALSE;
+		device_feauters.drawIndirectFirstInstance = multi_draw_indirect_ ? VK_TRUE : VK_FALSE;
+
+		VkPhysicalDeviceVulkan12Features vulkan_12_features{};
+		vulkan_12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		vulkan_12_features.timelineSemaphore = VK_TRUE;
 
 		VkDeviceCreateInfo device_create_info{};
 		device_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		device_create_info.pNext = &vulkan_12_features;
 		device_create_info.pQueueCreateInfos = queue_create_infos.data();
 		device_create_info.queueCreateInfoCount = static_cast<uint32_t>(unique_queue_families.size());
 		device_create_info.pEnabledFeatures = &device_feauters;
-		device_create_info.enabledExtensionCount = static_cast<uint32_t>(device_extensions_.size());
-		device_create_info.ppEnabledExtensionNames = device_extensions_.data();
+		auto extensions = GetRequiredExtensions();
+		device_create_info.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+		device_create_info.ppEnabledExtensionNames = extensions.data();
 
 #define NODEBUG
 #ifndef NODEBUG
@@ -126,21 +164,39 @@ namespace plaincraft_render_engine_vulkan
 	{
 		auto indices = FindQueueFamilyIndices(device, surface);
 
+		VkPhysicalDeviceFeatures device_features;
+		vkGetPhysicalDeviceFeatures(device, &device_features);
+
+		// Uploads signal timeline semaphores which are core since Vulkan 1.2
 		VkPhysicalDeviceProperties device_properties;
 		vkGetPhysicalDeviceProperties(device, &device_properties);
 
-		VkPhysicalDeviceFeatures device_features;
-		vkGetPhysicalDeviceFeatures(device, &device_features);
+		auto timeline_semaphore_supported = false;
+		if (device_properties.apiVersion >= VK_API_VERSION_1_2)
+		{
+			VkPhysicalDeviceVulkan12Features vulkan_12_features{};
+			vulkan_12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+			VkPhysicalDeviceFeatures2 device_features_2{};
+			device_features_2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			device_features_2.pNext = &vulkan_12_features;
+			vkGetPhysicalDeviceFeatures2(device, &device_features_2);
+
+			timeline_semaphore_supported = vulkan_12_features.timelineSemaphore == VK_TRUE;
+		}
 
 		const auto extensions_supported = CheckDeviceExtensionSupport(device);
-		auto swap_chain_adequate = false;
-		if (extensions_supported)
+		auto swap_chain_adequate = headless_;
+		if (extensions_supported && !headless_)
 		{
 			auto swap_chain_support_details = QuerySwapChainSupport(device, surface);
 			swap_chain_adequate = !swap_chain_support_details.formats.empty() && !swap_chain_support_details.present_modes.empty();
 		}
 
-		return indices.IsComplete() && device_properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU && device_features.geometryShader && extensions_supported && swap_chain_adequate && device_features.samplerAnisotropy;
+		// Rendering and single time commands run on two queues of the graphics family, a headless device does not render
+		auto queues_adequate = indices.IsComplete() && (headless_ || GetGraphicsQueuesCount(device, indices.graphics_family.value()) >= 2);
+
+		return queues_adequate && device_features.geometryShader && extensions_supported && swap_chain_adequate && device_features.samplerAnisotropy && timeline_semaphore_supported;
 	}
 
 	bool VulkanDevice::CheckDeviceExtensionSupport(VkPhysicalDevice device)
@@ -151,7 +207,8 @@ namespace plaincraft_render_engine_vulkan
 		std::vector<VkExtensionProperties> available_extensions(extensions_count);
 		vkEnumerateDeviceExtensionProperties(device, nullptr, &extensions_count, available_extensions.data());
 
-		std::set<std::string> required_extensions(device_extensions_.begin(), device_extensions_.end());
+		auto extensions = GetRequiredExtensions();
+		std::set<std::string> required_extensions(extensions.begin(), extensions.end());
 
 		for (const auto &extension : available_extensions)
 		{
@@ -161,6 +218,26 @@ namespace plaincraft_render_engine_vulkan
 		return required_extensions.empty();
 	}
 
+	uint32_t VulkanDevice::GetGraphicsQueuesCount(VkPhysicalDevice device, uint32_t graphics_family)
+	{
+		uint32_t queue_families_count = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_families_count, nullptr);
+
+		std::vector<VkQueueFamilyProperties> queue_families(queue_families_count);
+		vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_families_count, queue_families.data());
+
+		return queue_families[graphics_family].queueCount;
+	}
+
+	std::vector<const char *> VulkanDevice::GetRequiredExtensions() const
+	{
+		if (headless_)
+		{
+			return {};
+		}
+		return device_extensions_;
+	}
+
 	void VulkanDevice::CreateSyncObjects()
 	{
 	}
@@ -169,8 +246,28 @@ namespace plaincraft_render_engine_vulkan
 	{
 		auto indices = FindQueueFamilyIndices(physical_device_, surface);
 		vkGetDeviceQueue(device_, indices.graphics_family.value(), 0, &graphics_queue_);
-		vkGetDeviceQueue(device_, indices.graphics_family.value(), 1, &transfer_queue_);
+		if (GetGraphicsQueuesCount(physical_device_, indices.graphics_family.value()) > 1)
+		{
+			vkGetDeviceQueue(device_, indices.graphics_family.value(), 1, &transfer_queue_);
+		}
+		else
+		{
+			// Only headless devices get here, every submission then goes through the transfer queue mutex
+			transfer_queue_ = graphics_queue_;
+		}
 		vkGetDeviceQueue(device_, indices.present_family.value(), 0, &presentation_queue_);
+
+		graphics_queue_family_ = indices.graphics_family.value();
+		if (indices.transfer_family.has_value())
+		{
+			upload_queue_family_ = indices.transfer_family.value();
+			vkGetDeviceQueue(device_, upload_queue_family_, 0, &upload_queue_);
+		}
+		else
+		{
+			upload_queue_family_ = graphics_queue_family_;
+			upload_queue_ = transfer_queue_;
+		}
 	}
 
 	void VulkanDevice::CreateCommandPool(VkSurfaceKHR surface)
@@ -271,8 +368,16 @@ namespace plaincraft_render_engine_vulkan
 		submit_info.commandBufferCount = 1;
 		submit_info.pCommandBuffers = &command_buffer;
 
-		vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE);
-		vkQueueWaitIdle(queue);
+		{
+			std::unique_lock<std::mutex> lock;
+			if (queue == transfer_queue_)
+			{
+				lock = std::unique_lock(transfer_queue_mutex_);
+			}
+
+			vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE);
+			vkQueueWaitIdle(queue);
+		}
 
 		vkFreeCommandBuffers(device_, command_pool, 1, &command_buffer);
 	}
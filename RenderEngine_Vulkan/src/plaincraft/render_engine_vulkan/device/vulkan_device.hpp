@@ -28,9 +28,15 @@ SOFTWARE.
 #define PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_DEVICE
 
 #include "../instance/vulkan_instance.hpp"
+#include "../memory/vulkan_memory_allocator.hpp"
 #include <vulkan/vulkan.h>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace plaincraft_render_engine_vulkan {
+    class VulkanUploadManager;
+
     class VulkanDevice final {
     private:
         VkPhysicalDevice physical_device_ = VK_NULL_HANDLE;
@@ -39,15 +45,31 @@ namespace plaincraft_render_engine_vulkan {
         VkQueue graphics_queue_;
         VkQueue transfer_queue_;
         VkQueue presentation_queue_;
+        VkQueue upload_queue_;
+
+        uint32_t graphics_queue_family_;
+        uint32_t upload_queue_family_;
+
+        // Synchronous single time commands and the upload manager share the transfer queue
+        mutable std::mutex transfer_queue_mutex_;
 
         VkCommandPool graphics_command_pool_;
         VkCommandPool transfer_command_pool_;
 
+        bool multi_draw_indirect_ = false;
+
+        // Created without a surface, nothing is presented and the graphics queue may be the only one
+        bool headless_;
+
+        std::unique_ptr<VulkanMemoryAllocator> memory_allocator_;
+        std::unique_ptr<VulkanUploadManager> upload_manager_;
+
         const std::vector<const char*> device_extensions_ = {
 			VK_KHR_SWAPCHAIN_EXTENSION_NAME
 		};
 
     public:
+        // A null surface creates a headless device for tools that only compute and copy
         VulkanDevice(const VulkanInstance& instance, VkSurfaceKHR surface);
 
         ~VulkanDevice();
@@ -59,9 +81,22 @@ namespace plaincraft_render_engine_vulkan {
         auto GetTransferQueue() const -> VkQueue { return transfer_queue_; }
         auto GetPresentationQueue() const -> VkQueue { return presentation_queue_; }
 
+        // Dedicated transfer family queue when the device has one, the second graphics queue otherwise
+        auto GetUploadQueue() const -> VkQueue { return upload_queue_; }
+        auto GetTransferQueueMutex() const -> std::mutex& { return transfer_queue_mutex_; }
+
+        auto GetGraphicsQueueFamily() const -> uint32_t { return graphics_queue_family_; }
+        auto GetUploadQueueFamily() const -> uint32_t { return upload_queue_family_; }
+
         auto GetGraphicsCommandPool() const -> VkCommandPool { return graphics_command_pool_; }
         auto GetTransferCommandPool() const -> VkCommandPool { return transfer_command_pool_; }
 
+        // Indirect draws with more than one command and with a non-zero first instance
+        auto SupportsMultiDrawIndirect() const -> bool { return multi_draw_indirect_; }
+
+        auto GetMemoryAllocator() const -> VulkanMemoryAllocator& { return *memory_allocator_; }
+        auto GetUploadManager() const -> VulkanUploadManager& { return *upload_manager_; }
+
         uint32_t FindMemoryType(uint32_t type_filter, VkMemoryPropertyFlags memory_properties) const;
         VkFormat FindSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features) const;
         
@@ -76,6 +111,8 @@ namespace plaincraft_render_engine_vulkan {
         
         bool IsDeviceSuitable(VkPhysicalDevice device, VkSurfaceKHR surface);
         bool CheckDeviceExtensionSupport(VkPhysicalDevice device);
+        uint32_t GetGraphicsQueuesCount(VkPhysicalDevice device, uint32_t graphics_family);
+        std::vector<const char*> GetRequiredExtensions() const;
 
         void CreateSyncObjects();
         void CreateQueues(VkSurfaceKHR surface);
@@ -89,7 +89,7 @@ namespace plaincraft_render_engine_vulkan
 		application_info.applicationVersion = config_.application_version;
 		application_info.pEngineName = config_.engine_name.c_str();
 		application_info.engineVersion = config_.engine_version;
-		application_info.apiVersion = VK_API_VERSION_1_0;
+		application_info.apiVersion = VK_API_VERSION_1_2;
 
 		VkInstanceCreateInfo create_info{};
 		create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -159,11 +159,14 @@ namespace plaincraft_render_engine_vulkan
     }
 
     std::vector<const char*> VulkanInstance::GetRequiredExtensions() {
-		uint32_t glfw_extension_count = 0;
-		const char** glfw_extensions;
-		glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
+		std::vector<const char*> extensions;
+		if (!config_.headless) {
+			uint32_t glfw_extension_count = 0;
+			const char** glfw_extensions;
+			glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
 
-		std::vector<const char*> extensions(glfw_extensions, glfw_extensions + glfw_extension_count);
+			extensions.assign(glfw_extensions, glfw_extensions + glfw_extension_count);
+		}
 
 		if (config_.enable_debug) {
 			extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
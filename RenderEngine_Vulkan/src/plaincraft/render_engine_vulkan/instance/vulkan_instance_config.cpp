@@ -34,7 +34,8 @@ namespace plaincraft_render_engine_vulkan
           application_name("Plaincraft"),
           application_version(VK_MAKE_VERSION(1, 0, 0)),
           engine_name("Plaincraft engine"),
-          engine_version(VK_MAKE_VERSION(1, 0, 0))
+          engine_version(VK_MAKE_VERSION(1, 0, 0)),
+          headless(false)
     {
     }
 }
\ No newline at end of file
@@ -41,6 +41,9 @@ namespace plaincraft_render_engine_vulkan
 
         bool enable_debug;
 
+        // Without a window there is no surface, so none of the window system extensions are needed
+        bool headless;
+
         VulkanInstanceConfig();
     };
 }
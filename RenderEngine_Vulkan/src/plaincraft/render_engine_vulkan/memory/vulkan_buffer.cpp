@@ -25,22 +25,30 @@ SOFTWARE.
 */
 
 #include "vulkan_buffer.hpp"
+#include "vulkan_upload_manager.hpp"
 #include <stdexcept>
 
 namespace plaincraft_render_engine_vulkan
 {
-    VulkanBuffer::VulkanBuffer(const VulkanDevice &device, VkDeviceSize size, VkBufferUsageFlags usage_flags, VkMemoryPropertyFlags memory_properties, VkDeviceSize min_offset_alignment)
-        : VulkanBuffer(device, size, 1, usage_flags, memory_properties, min_offset_alignment)
+    VulkanBuffer::VulkanBuffer(const VulkanDevice &device, VkDeviceSize size, VkBufferUsageFlags usage_flags, VkMemoryPropertyFlags memory_properties, VkDeviceSize min_offset_alignment, VkSharingMode sharing_mode)
+        : VulkanBuffer(device, size, 1, usage_flags, memory_properties, min_offset_alignment, sharing_mode)
     {
     }
 
-    VulkanBuffer::VulkanBuffer(const VulkanDevice &device, VkDeviceSize instance_size, uint32_t instance_count, VkBufferUsageFlags usage_flags, VkMemoryPropertyFlags memory_properties, VkDeviceSize min_offset_alignment)
+    VulkanBuffer::VulkanBuffer(const VulkanDevice &device, VkDeviceSize instance_size, uint32_t instance_count, VkBufferUsageFlags usage_flags, VkMemoryPropertyFlags memory_properties, VkDeviceSize min_offset_alignment, VkSharingMode sharing_mode)
         : device_(device),
           instance_size_(instance_size),
           instance_count_(instance_count),
           memory_property_flags_(memory_properties),
-          buffer_usage_flags_(usage_flags)
+          buffer_usage_flags_(usage_flags),
+          sharing_mode_(sharing_mode)
     {
+        // Concurrent sharing only makes sense when uploads run on a family of their own
+        if (device.GetUploadQueueFamily() == device.GetGraphicsQueueFamily())
+        {
+            sharing_mode_ = VK_SHARING_MODE_EXCLUSIVE;
+        }
+
         alignment_size_ = GetAlignment(min_offset_alignment);
         buffer_size_ = alignment_size_ * instance_count_;
         CreateBuffer();
@@ -49,22 +57,25 @@ namespace plaincraft_render_engine_vulkan
     VulkanBuffer::VulkanBuffer(VulkanBuffer &&other) noexcept
         : device_(other.device_),
           buffer_(other.buffer_),
-          memory_(other.memory_),
+          allocation_(other.allocation_),
           buffer_size_(other.buffer_size_),
           instance_count_(other.instance_count_),
           instance_size_(other.instance_size_),
           alignment_size_(other.alignment_size_),
           buffer_usage_flags_(other.buffer_usage_flags_),
-          memory_property_flags_(other.memory_property_flags_)
+          memory_property_flags_(other.memory_property_flags_),
+          sharing_mode_(other.sharing_mode_),
+          upload_value_(other.upload_value_)
     {
         other.buffer_ = VK_NULL_HANDLE;
-        other.memory_ = VK_NULL_HANDLE;
+        other.allocation_ = VulkanMemoryAllocation{};
         other.buffer_size_ = 0;
         other.instance_count_ = 0;
         other.instance_size_ = 0;
         other.alignment_size_ = 0;
         other.buffer_usage_flags_ = 0;
         other.memory_property_flags_ = 0;
+        other.upload_value_ = 0;
     }
 
     VulkanBuffer &VulkanBuffer::operator=(VulkanBuffer &&other) noexcept
@@ -74,51 +85,54 @@ namespace plaincraft_render_engine_vulkan
             return *this;
         }
 
+        DestroyBuffer();
+
         this->device_ = other.device_;
 
         this->buffer_ = other.buffer_;
-        this->memory_ = other.memory_;
+        this->allocation_ = other.allocation_;
         this->buffer_size_ = other.buffer_size_;
         this->instance_count_ = other.instance_count_;
         this->instance_size_ = other.instance_size_;
         this->alignment_size_ = other.alignment_size_;
         this->buffer_usage_flags_ = other.buffer_usage_flags_;
         this->memory_property_flags_ = other.memory_property_flags_;
+        this->sharing_mode_ = other.sharing_mode_;
+        this->upload_value_ = other.upload_value_;
 
         other.buffer_ = VK_NULL_HANDLE;
-        other.memory_ = VK_NULL_HANDLE;
+        other.allocation_ = VulkanMemoryAllocation{};
         other.buffer_size_ = 0;
         other.instance_count_ = 0;
         other.instance_size_ = 0;
         other.alignment_size_ = 0;
         other.buffer_usage_flags_ = 0;
         other.memory_property_flags_ = 0;
+        other.upload_value_ = 0;
 
         return *this;
     }
 
     VulkanBuffer::~VulkanBuffer()
     {
-        vkDestroyBuffer(device_.get().GetDevice(), buffer_, nullptr);
-        vkFreeMemory(device_.get().GetDevice(), memory_, nullptr);
+        DestroyBuffer();
     }
 
     VkResult VulkanBuffer::Map(VkDeviceSize size, VkDeviceSize offset)
     {
-        if (size == VK_WHOLE_SIZE)
+        // Host visible blocks of the allocator are mapped once for good, mapping only hands out this buffer's range
+        if (allocation_.mapped_data == nullptr)
         {
-            return vkMapMemory(device_.get().GetDevice(), memory_, 0, buffer_size_, 0, &mapped_data_);
+            return VK_ERROR_MEMORY_MAP_FAILED;
         }
-        return vkMapMemory(device_.get().GetDevice(), memory_, offset, size, 0, &mapped_data_);
+
+        mapped_data_ = static_cast<char *>(allocation_.mapped_data) + (size == VK_WHOLE_SIZE ? 0 : offset);
+        return VK_SUCCESS;
     }
 
     void VulkanBuffer::Unmap()
     {
-        if (mapped_data_)
-        {
-            vkUnmapMemory(device_.get().GetDevice(), memory_);
-            mapped_data_ = nullptr;
-        }
+        mapped_data_ = nullptr;
     }
 
     void VulkanBuffer::Write(void *data, VkDeviceSize size, VkDeviceSize offset)
@@ -134,37 +148,24 @@ namespace plaincraft_render_engine_vulkan
         }
     }
 
-    void VulkanBuffer::CopyFromBuffer(const VulkanBuffer &other)
+    void VulkanBuffer::CopyFromBuffer(std::shared_ptr<VulkanBuffer> other)
     {
-        auto &device = device_.get();
-        auto command_buffer = device.BeginSingleTimeCommands(device.GetTransferCommandPool());
-
-        VkBufferCopy copy_region{};
-        copy_region.srcOffset = 0;
-        copy_region.dstOffset = 0;
-        copy_region.size = other.GetBufferSize();
-        vkCmdCopyBuffer(command_buffer, other.buffer_, buffer_, 1, &copy_region);
-
-        device.EndSingleTimeCommands(device.GetTransferCommandPool(), command_buffer, device.GetTransferQueue());
+        auto size = other->GetBufferSize();
+        upload_value_ = device_.get().GetUploadManager().CopyBuffer(std::move(other), *this, 0, size);
     }
 
     VulkanBuffer VulkanBuffer::MoveBuffer(const VulkanDevice &device, VulkanBuffer &&buffer, VkBufferUsageFlags buffer_usage_flags, VkMemoryPropertyFlags memory_properties)
     {
         VulkanBuffer result(device, buffer.GetInstanceSize(), buffer.GetInstanceCount(), buffer_usage_flags, memory_properties);
 
-        result.CopyFromBuffer(buffer);
+        result.CopyFromBuffer(std::make_shared<VulkanBuffer>(std::move(buffer)));
 
         return result;
     }
 
     VkResult VulkanBuffer::Flush(VkDeviceSize size, VkDeviceSize offset)
     {
-        VkMappedMemoryRange mapped_memory_range{};
-        mapped_memory_range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-        mapped_memory_range.memory = memory_;
-        mapped_memory_range.offset = offset;
-        mapped_memory_range.size = size;
-        return vkFlushMappedMemoryRanges(device_.get().GetDevice(), 1, &mapped_memory_range);
+        return device_.get().GetMemoryAllocator().Flush(allocation_, size, offset);
     }
 
     void VulkanBuffer::CreateBuffer()
@@ -173,7 +174,14 @@ namespace plaincraft_render_engine_vulkan
         buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         buffer_info.size = buffer_size_;
         buffer_info.usage = buffer_usage_flags_;
-        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        buffer_info.sharingMode = sharing_mode_;
+
+        uint32_t queue_families[] = {device_.get().GetGraphicsQueueFamily(), device_.get().GetUploadQueueFamily()};
+        if (sharing_mode_ == VK_SHARING_MODE_CONCURRENT)
+        {
+            buffer_info.queueFamilyIndexCount = 2;
+            buffer_info.pQueueFamilyIndices = queue_families;
+        }
 
         auto device = device_.get().GetDevice();
 
@@ -185,17 +193,28 @@ namespace plaincraft_render_engine_vulkan
         VkMemoryRequirements memory_requirements;
         vkGetBufferMemoryRequirements(device, buffer_, &memory_requirements);
 
-        VkMemoryAllocateInfo allocate_info{};
-        allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocate_info.allocationSize = memory_requirements.size;
-        allocate_info.memoryTypeIndex = device_.get().FindMemoryType(memory_requirements.memoryTypeBits, memory_property_flags_);
+        auto memory_type_index = device_.get().FindMemoryType(memory_requirements.memoryTypeBits, memory_property_flags_);
+        allocation_ = device_.get().GetMemoryAllocator().Allocate(memory_requirements, memory_type_index, VulkanMemoryAllocator::ResourceTiling::Linear);
 
-        if (vkAllocateMemory(device, &allocate_info, nullptr, &memory_) != VK_SUCCESS)
+        vkBindBufferMemory(device, buffer_, allocation_.memory, allocation_.offset);
+    }
+
+    void VulkanBuffer::DestroyBuffer()
+    {
+        if (buffer_ != VK_NULL_HANDLE)
         {
-            throw std::runtime_error("Failed to allocate vertex buffer memory");
+            // The transfer queue may still be writing into a buffer that was released right after its creation
+            if (upload_value_ != 0)
+            {
+                device_.get().GetUploadManager().Wait(upload_value_);
+                device_.get().GetUploadManager().ForgetBuffer(buffer_);
+            }
+
+            vkDestroyBuffer(device_.get().GetDevice(), buffer_, nullptr);
+            buffer_ = VK_NULL_HANDLE;
         }
-
-        vkBindBufferMemory(device, buffer_, memory_, 0);
+        device_.get().GetMemoryAllocator().Free(allocation_);
+        mapped_data_ = nullptr;
     }
 
     VkDeviceSize VulkanBuffer::GetAlignment(VkDeviceSize min_offset_alignment)
@@ -30,6 +30,7 @@ SOFTWARE.
 #include "../device/vulkan_device.hpp"
 #include <vulkan/vulkan.h>
 #include <functional>
+#include <memory>
 
 namespace plaincraft_render_engine_vulkan
 {
@@ -38,19 +39,23 @@ namespace plaincraft_render_engine_vulkan
     private:
         std::reference_wrapper<const VulkanDevice> device_;
         VkBuffer buffer_;
-        VkDeviceMemory memory_;
+        VulkanMemoryAllocation allocation_;
         VkDeviceSize buffer_size_;
         uint32_t instance_count_;
         VkDeviceSize instance_size_;
         VkDeviceSize alignment_size_;
         VkBufferUsageFlags buffer_usage_flags_;
         VkMemoryPropertyFlags memory_property_flags_;
+        VkSharingMode sharing_mode_;
 
         void* mapped_data_ = nullptr;
 
+        // Timeline value of the upload manager batch which fills the buffer, zero when it is written by the host
+        uint64_t upload_value_ = 0;
+
     public:
-        VulkanBuffer(const VulkanDevice &device, VkDeviceSize size, VkBufferUsageFlags usage_flags, VkMemoryPropertyFlags memory_properties, VkDeviceSize min_offset_alignment = 1);
-        VulkanBuffer(const VulkanDevice &device, VkDeviceSize instance_size, uint32_t instance_count, VkBufferUsageFlags usage_flags, VkMemoryPropertyFlags memory_properties, VkDeviceSize min_offset_alignment = 1);
+        VulkanBuffer(const VulkanDevice &device, VkDeviceSize size, VkBufferUsageFlags usage_flags, VkMemoryPropertyFlags memory_properties, VkDeviceSize min_offset_alignment = 1, VkSharingMode sharing_mode = VK_SHARING_MODE_EXCLUSIVE);
+        VulkanBuffer(const VulkanDevice &device, VkDeviceSize instance_size, uint32_t instance_count, VkBufferUsageFlags usage_flags, VkMemoryPropertyFlags memory_properties, VkDeviceSize min_offset_alignment = 1, VkSharingMode sharing_mode = VK_SHARING_MODE_EXCLUSIVE);
 
         VulkanBuffer(const VulkanBuffer& other) = delete;
         VulkanBuffer& operator=(const VulkanBuffer& other) = delete;
@@ -67,7 +72,8 @@ namespace plaincraft_render_engine_vulkan
         void Write(void* data, VkDeviceSize size, VkDeviceSize offset);
 
         auto GetBuffer() -> VkBuffer { return buffer_; }
-        auto GetMemory() -> VkDeviceMemory { return memory_; }
+        auto GetMemory() -> VkDeviceMemory { return allocation_.memory; }
+        auto GetMemoryOffset() -> VkDeviceSize { return allocation_.offset; }
         auto GetBufferSize() const -> VkDeviceSize { return buffer_size_; }
         auto GetInstanceCount() -> uint32_t { return instance_count_; }
         auto GetInstanceSize() -> VkDeviceSize { return instance_size_; }
@@ -75,8 +81,11 @@ namespace plaincraft_render_engine_vulkan
         auto GetBufferUsageFlags() -> VkBufferUsageFlags { return buffer_usage_flags_; }
         auto GetMemoryPropertyFlags() -> VkMemoryPropertyFlags { return memory_property_flags_; }
         auto GetMappedData() -> void* { return mapped_data_; }
+        auto GetSharingMode() const -> VkSharingMode { return sharing_mode_; }
+        auto GetUploadValue() const -> uint64_t { return upload_value_; }
 
-        void CopyFromBuffer(const VulkanBuffer& other);
+        // Queues the copy on the upload manager which keeps the source alive until the copy completes
+        void CopyFromBuffer(std::shared_ptr<VulkanBuffer> other);
 
         template<typename T>
         static VulkanBuffer CreateFromVector(const VulkanDevice& device, std::vector<T> data, VkBufferUsageFlags buffer_usage_flags, VkMemoryPropertyFlags memory_properties);
@@ -85,6 +94,7 @@ namespace plaincraft_render_engine_vulkan
 
     private:
         void CreateBuffer();
+        void DestroyBuffer();
 
         VkDeviceSize GetAlignment(VkDeviceSize min_offset_alignment);
     };
@@ -0,0 +1,94 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_frame_allocator.hpp"
+#include <stdexcept>
+
+namespace plaincraft_render_engine_vulkan
+{
+    VulkanFrameAllocator::VulkanFrameAllocator(const VulkanDevice &device, size_t frames_count, VkBufferUsageFlags usage_flags)
+        : device_(device),
+          usage_flags_(usage_flags)
+    {
+        frames_.resize(frames_count);
+        for (auto &frame : frames_)
+        {
+            frame.buffer = CreateFrameBuffer(initial_frame_capacity);
+        }
+    }
+
+    bool VulkanFrameAllocator::BeginFrame(uint32_t frame_index, VkDeviceSize required_size)
+    {
+        frame_index_ = frame_index;
+
+        auto &frame = frames_[frame_index_];
+        frame.used_bytes = 0;
+
+        auto capacity = frame.buffer->GetBufferSize();
+        if (capacity >= required_size)
+        {
+            return false;
+        }
+
+        while (capacity < required_size)
+        {
+            capacity *= 2;
+        }
+
+        // The previous submission of this image has completed, so nothing reads the old buffer anymore
+        frame.buffer = CreateFrameBuffer(capacity);
+        return true;
+    }
+
+    VulkanFrameAllocator::Allocation VulkanFrameAllocator::Allocate(VkDeviceSize size, VkDeviceSize alignment)
+    {
+        auto &frame = frames_[frame_index_];
+
+        auto offset = (frame.used_bytes + alignment - 1) & ~(alignment - 1);
+        if (offset + size > frame.buffer->GetBufferSize())
+        {
+            throw std::runtime_error("Frame allocator capacity exceeded");
+        }
+
+        frame.used_bytes = offset + size;
+        return Allocation{offset, static_cast<char *>(frame.buffer->GetMappedData()) + offset};
+    }
+
+    std::unique_ptr<VulkanBuffer> VulkanFrameAllocator::CreateFrameBuffer(VkDeviceSize capacity)
+    {
+        auto buffer = std::make_unique<VulkanBuffer>(device_,
+                                                     capacity,
+                                                     usage_flags_,
+                                                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        if (buffer->Map(VK_WHOLE_SIZE, 0) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to map frame allocator buffer");
+        }
+
+        return buffer;
+    }
+}
@@ -0,0 +1,96 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_FRAME_ALLOCATOR
+#define PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_FRAME_ALLOCATOR
+
+#include "../device/vulkan_device.hpp"
+#include "vulkan_buffer.hpp"
+#include <vulkan/vulkan.h>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace plaincraft_render_engine_vulkan
+{
+    // Linear allocator over one persistently mapped buffer per swapchain image. Uniforms, instance data and indirect
+    // commands of a frame are written straight into it and released all at once when the image comes around again.
+    class VulkanFrameAllocator
+    {
+    public:
+        struct Allocation
+        {
+            VkDeviceSize offset;
+            void *data;
+        };
+
+    private:
+        static constexpr VkDeviceSize initial_frame_capacity = 4 * 1024 * 1024;
+
+        struct Frame
+        {
+            std::unique_ptr<VulkanBuffer> buffer;
+            VkDeviceSize used_bytes = 0;
+        };
+
+        const VulkanDevice &device_;
+        VkBufferUsageFlags usage_flags_;
+        std::vector<Frame> frames_;
+        uint32_t frame_index_ = 0;
+
+    public:
+        VulkanFrameAllocator(const VulkanDevice &device, size_t frames_count, VkBufferUsageFlags usage_flags);
+
+        VulkanFrameAllocator(const VulkanFrameAllocator &other) = delete;
+        VulkanFrameAllocator &operator=(const VulkanFrameAllocator &other) = delete;
+
+        // Rewinds the frame, returns true when its buffer had to be replaced to fit the required size
+        bool BeginFrame(uint32_t frame_index, VkDeviceSize required_size);
+
+        // Alignment has to be a power of two
+        Allocation Allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+        template <typename T>
+        Allocation Write(const T *data, size_t count, VkDeviceSize alignment);
+
+        auto GetBuffer(uint32_t frame_index) -> VulkanBuffer & { return *frames_[frame_index].buffer; }
+        auto GetUsedBytes() const -> VkDeviceSize { return frames_[frame_index_].used_bytes; }
+        auto GetCapacity() const -> VkDeviceSize { return frames_[frame_index_].buffer->GetBufferSize(); }
+
+    private:
+        std::unique_ptr<VulkanBuffer> CreateFrameBuffer(VkDeviceSize capacity);
+    };
+
+    template <typename T>
+    VulkanFrameAllocator::Allocation VulkanFrameAllocator::Write(const T *data, size_t count, VkDeviceSize alignment)
+    {
+        auto allocation = Allocate(sizeof(T) * count, alignment);
+        memcpy(allocation.data, data, sizeof(T) * count);
+        return allocation;
+    }
+}
+
+#endif // PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_FRAME_ALLOCATOR
@@ -25,6 +25,8 @@ SOFTWARE.
 */
 
 #include "vulkan_image.hpp"
+#include "vulkan_buffer.hpp"
+#include "vulkan_upload_manager.hpp"
 #include <stdexcept>
 
 namespace plaincraft_render_engine_vulkan
@@ -49,16 +51,19 @@ namespace plaincraft_render_engine_vulkan
 
     VulkanImage::VulkanImage(VulkanImage &&other)
         : device_(other.device_),
+          image_(other.image_),
+          image_allocation_(other.image_allocation_),
           width_(other.width_),
           height_(other.height_),
           format_(other.format_),
           image_tiling_(other.image_tiling_),
           image_usage_flags_(other.image_usage_flags_),
-          memory_property_flags_(other.memory_property_flags_)
-
+          memory_property_flags_(other.memory_property_flags_),
+          upload_value_(other.upload_value_)
     {
         other.image_ = VK_NULL_HANDLE;
-        other.image_memory_ = VK_NULL_HANDLE;
+        other.image_allocation_ = VulkanMemoryAllocation{};
+        other.upload_value_ = 0;
     }
 
     VulkanImage &VulkanImage::operator=(VulkanImage &&other)
@@ -68,34 +73,33 @@ namespace plaincraft_render_engine_vulkan
             return *this;
         }
 
+        DestroyImage();
+
+        this->device_ = other.device_;
         this->image_ = other.image_;
         this->format_ = other.format_;
-        this->image_memory_ = other.image_memory_;
+        this->image_allocation_ = other.image_allocation_;
         this->width_ = other.width_;
         this->height_ = other.height_;
         this->image_tiling_ = other.image_tiling_;
         this->memory_property_flags_ = other.memory_property_flags_;
+        this->upload_value_ = other.upload_value_;
 
         other.image_ = VK_NULL_HANDLE;
-        other.image_memory_ = VK_NULL_HANDLE;
+        other.image_allocation_ = VulkanMemoryAllocation{};
         other.format_ = VK_FORMAT_UNDEFINED;
         other.width_ = 0;
         other.height_ = 0;
         other.image_tiling_ = VK_IMAGE_TILING_OPTIMAL;
         other.memory_property_flags_ = 0;
+        other.upload_value_ = 0;
 
         return *this;
     }
 
     VulkanImage::~VulkanImage()
     {
-        auto &device = device_.get();
-        vkDestroyImage(device.GetDevice(), image_, nullptr);
-
-        // if(image_memory_ != VK_NULL_HANDLE)
-        // {
-        //     vkFreeMemory(device.GetDevice(), image_memory_, nullptr);
-        // }
+        DestroyImage();
     }
 
     VkImage VulkanImage::GetImage() const
@@ -105,7 +109,7 @@ namespace plaincraft_render_engine_vulkan
 
     VkDeviceMemory VulkanImage::GetImageMemory() const
     {
-        return image_memory_;
+        return image_allocation_.memory;
     }
 
     uint32_t VulkanImage::GetWidth() const
@@ -123,27 +127,14 @@ namespace plaincraft_render_engine_vulkan
         return format_;
     }
 
-    void VulkanImage::CopyBufferToImage(VkBuffer buffer, uint32_t width, uint32_t height)
+    uint64_t VulkanImage::GetUploadValue() const
     {
-        auto &device = device_.get();
-        auto command_buffer = device.BeginSingleTimeCommands(device.GetTransferCommandPool());
-
-        VkBufferImageCopy image_copy_region{};
-        image_copy_region.bufferOffset = 0;
-        image_copy_region.bufferRowLength = 0;
-        image_copy_region.bufferImageHeight = 0;
-
-        image_copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        image_copy_region.imageSubresource.mipLevel = 0;
-        image_copy_region.imageSubresource.baseArrayLayer = 0;
-        image_copy_region.imageSubresource.layerCount = 1;
-
-        image_copy_region.imageOffset = {0, 0, 0};
-        image_copy_region.imageExtent = {width, height, 1};
-
-        vkCmdCopyBufferToImage(command_buffer, buffer, image_, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &image_copy_region);
+        return upload_value_;
+    }
 
-        device.EndSingleTimeCommands(device.GetTransferCommandPool(), command_buffer, device.GetTransferQueue());
+    void VulkanImage::CopyBufferToImage(std::shared_ptr<VulkanBuffer> buffer, uint32_t width, uint32_t height)
+    {
+        upload_value_ = device_.get().GetUploadManager().CopyBufferToImage(std::move(buffer), image_, width, height);
     }
 
     void VulkanImage::CreateImage()
@@ -177,16 +168,27 @@ namespace plaincraft_render_engine_vulkan
         VkMemoryRequirements memory_requirements;
         vkGetImageMemoryRequirements(vk_device, image_, &memory_requirements);
 
-        VkMemoryAllocateInfo memory_allocate_info{};
-        memory_allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        memory_allocate_info.allocationSize = memory_requirements.size;
-        memory_allocate_info.memoryTypeIndex = device.FindMemoryType(memory_requirements.memoryTypeBits, memory_property_flags_);
+        auto memory_type_index = device.FindMemoryType(memory_requirements.memoryTypeBits, memory_property_flags_);
+        auto tiling = image_tiling_ == VK_IMAGE_TILING_LINEAR ? VulkanMemoryAllocator::ResourceTiling::Linear : VulkanMemoryAllocator::ResourceTiling::Optimal;
+        image_allocation_ = device.GetMemoryAllocator().Allocate(memory_requirements, memory_type_index, tiling);
+
+        vkBindImageMemory(vk_device, image_, image_allocation_.memory, image_allocation_.offset);
+    }
 
-        if (vkAllocateMemory(vk_device, &memory_allocate_info, nullptr, &image_memory_) != VK_SUCCESS)
+    void VulkanImage::DestroyImage()
+    {
+        auto &device = device_.get();
+        if (image_ != VK_NULL_HANDLE)
         {
-            throw std::runtime_error("Failed to allocate image memory");
+            if (upload_value_ != 0)
+            {
+                device.GetUploadManager().Wait(upload_value_);
+                device.GetUploadManager().ForgetImage(image_);
+            }
+
+            vkDestroyImage(device.GetDevice(), image_, nullptr);
+            image_ = VK_NULL_HANDLE;
         }
-
-        vkBindImageMemory(vk_device, image_, image_memory_, 0);
+        device.GetMemoryAllocator().Free(image_allocation_);
     }
 }
\ No newline at end of file
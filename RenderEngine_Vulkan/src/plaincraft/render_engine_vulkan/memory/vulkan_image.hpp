@@ -30,16 +30,19 @@ SOFTWARE.
 #include "../device/vulkan_device.hpp"
 #include <vulkan/vulkan.h>
 #include <functional>
+#include <memory>
 
 namespace plaincraft_render_engine_vulkan
 {
+    class VulkanBuffer;
+
     class VulkanImage
     {
     protected:
         std::reference_wrapper<const VulkanDevice> device_;
 
         VkImage image_;
-        VkDeviceMemory image_memory_;
+        VulkanMemoryAllocation image_allocation_;
         VkFormat format_;
         VkImageTiling image_tiling_;
         VkImageUsageFlags image_usage_flags_;
@@ -48,6 +51,9 @@ namespace plaincraft_render_engine_vulkan
         uint32_t width_;
         uint32_t height_;
 
+        // Timeline value of the upload manager batch which fills the image
+        uint64_t upload_value_ = 0;
+
     public:
         VulkanImage(const VulkanDevice& device, 
             uint32_t width, 
@@ -66,16 +72,19 @@ namespace plaincraft_render_engine_vulkan
 
         virtual ~VulkanImage();
 
-        void CopyBufferToImage(VkBuffer buffer, uint32_t width, uint32_t height);
+        // Queues the copy on the upload manager, the image ends up in the shader read only layout
+        void CopyBufferToImage(std::shared_ptr<VulkanBuffer> buffer, uint32_t width, uint32_t height);
 
         VkImage GetImage() const;
         VkDeviceMemory GetImageMemory() const;
         uint32_t GetWidth() const;
         uint32_t GetHeight() const;
         VkFormat GetFormat() const;
+        uint64_t GetUploadValue() const;
 
     private:
         void CreateImage();
+        void DestroyImage();
         void CreateImageView();
     };
 }
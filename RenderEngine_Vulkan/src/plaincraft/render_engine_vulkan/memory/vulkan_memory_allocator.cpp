@@ -0,0 +1,189 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_memory_allocator.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace plaincraft_render_engine_vulkan
+{
+    VulkanMemoryAllocator::VulkanMemoryAllocator(VkPhysicalDevice physical_device, VkDevice device)
+        : device_(device)
+    {
+        vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties_);
+
+        VkPhysicalDeviceProperties physical_device_properties;
+        vkGetPhysicalDeviceProperties(physical_device, &physical_device_properties);
+        non_coherent_atom_size_ = physical_device_properties.limits.nonCoherentAtomSize;
+
+        pools_.resize(memory_properties_.memoryTypeCount * 2);
+    }
+
+    VulkanMemoryAllocation VulkanMemoryAllocator::Allocate(const VkMemoryRequirements &memory_requirements, uint32_t memory_type_index, ResourceTiling tiling)
+    {
+        auto property_flags = memory_properties_.memoryTypes[memory_type_index].propertyFlags;
+        auto host_visible = (property_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+
+        // Flushed ranges have to start and end at multiples of nonCoherentAtomSize without touching other resources
+        auto alignment = memory_requirements.alignment;
+        if (host_visible && (property_flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0)
+        {
+            alignment = std::max(alignment, non_coherent_atom_size_);
+        }
+
+        auto granularity = VulkanMemoryBlock::region_granularity;
+        auto size = (memory_requirements.size + granularity - 1) & ~(granularity - 1);
+
+        auto pool_index = memory_type_index * 2 + (tiling == ResourceTiling::Linear ? 0 : 1);
+        auto block_size = GetBlockSize(memory_type_index);
+
+        std::lock_guard<std::mutex> lock(allocator_mutex_);
+        auto &pool = pools_[pool_index];
+
+        VulkanMemoryAllocation allocation{};
+        VulkanMemoryBlock *block = nullptr;
+
+        if (size > block_size / 2)
+        {
+            pool.push_back(std::make_unique<VulkanMemoryBlock>(device_, size, memory_type_index, pool_index, host_visible, true));
+            block = pool.back().get();
+
+            // The whole block is used and its start satisfies any alignment
+            if (!block->Allocate(size, granularity, allocation.offset, allocation.region))
+            {
+                pool.pop_back();
+                throw std::runtime_error("Failed to allocate dedicated device memory");
+            }
+        }
+        else
+        {
+            for (auto &pool_block : pool)
+            {
+                if (!pool_block->IsDedicated() && pool_block->Allocate(size, alignment, allocation.offset, allocation.region))
+                {
+                    block = pool_block.get();
+                    break;
+                }
+            }
+
+            if (block == nullptr)
+            {
+                pool.push_back(std::make_unique<VulkanMemoryBlock>(device_, block_size, memory_type_index, pool_index, host_visible, false));
+                block = pool.back().get();
+                if (!block->Allocate(size, alignment, allocation.offset, allocation.region))
+                {
+                    throw std::runtime_error("Failed to suballocate device memory");
+                }
+            }
+        }
+
+        allocation.memory = block->GetMemory();
+        allocation.size = size;
+        allocation.block = block;
+        if (block->GetMappedData() != nullptr)
+        {
+            allocation.mapped_data = static_cast<char *>(block->GetMappedData()) + allocation.offset;
+        }
+
+        return allocation;
+    }
+
+    void VulkanMemoryAllocator::Free(VulkanMemoryAllocation &allocation)
+    {
+        if (allocation.block == nullptr)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(allocator_mutex_);
+
+        auto block = allocation.block;
+        block->Free(allocation.region);
+        allocation = VulkanMemoryAllocation{};
+
+        if (!block->IsEmpty())
+        {
+            return;
+        }
+
+        // One empty block is kept per pool, so resources recreated all the time do not allocate memory all the time
+        auto &pool = pools_[block->GetPoolIndex()];
+        auto empty_blocks_count = std::count_if(pool.begin(), pool.end(), [](const auto &pool_block)
+                                                { return !pool_block->IsDedicated() && pool_block->IsEmpty(); });
+
+        if (block->IsDedicated() || empty_blocks_count > 1)
+        {
+            pool.erase(std::find_if(pool.begin(), pool.end(), [block](const auto &pool_block)
+                                    { return pool_block.get() == block; }));
+        }
+    }
+
+    VkResult VulkanMemoryAllocator::Flush(const VulkanMemoryAllocation &allocation, VkDeviceSize size, VkDeviceSize offset)
+    {
+        auto begin = allocation.offset + offset;
+        auto end = size == VK_WHOLE_SIZE ? allocation.offset + allocation.size : begin + size;
+
+        begin &= ~(non_coherent_atom_size_ - 1);
+        end = (end + non_coherent_atom_size_ - 1) & ~(non_coherent_atom_size_ - 1);
+
+        VkMappedMemoryRange mapped_memory_range{};
+        mapped_memory_range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        mapped_memory_range.memory = allocation.memory;
+        mapped_memory_range.offset = begin;
+        mapped_memory_range.size = end >= allocation.block->GetSize() ? VK_WHOLE_SIZE : end - begin;
+        return vkFlushMappedMemoryRanges(device_, 1, &mapped_memory_range);
+    }
+
+    VulkanMemoryAllocator::Statistics VulkanMemoryAllocator::GetStatistics()
+    {
+        std::lock_guard<std::mutex> lock(allocator_mutex_);
+
+        Statistics statistics{};
+        for (auto &pool : pools_)
+        {
+            for (auto &block : pool)
+            {
+                ++statistics.blocks_count;
+                statistics.dedicated_blocks_count += block->IsDedicated() ? 1 : 0;
+                statistics.allocations_count += block->GetAllocationsCount();
+                statistics.free_regions_count += block->GetFreeRegionsCount();
+                statistics.capacity_bytes += block->GetSize();
+                statistics.used_bytes += block->GetUsedBytes();
+                statistics.largest_free_region = std::max(statistics.largest_free_region, block->GetLargestFreeRegion());
+            }
+        }
+        return statistics;
+    }
+
+    VkDeviceSize VulkanMemoryAllocator::GetBlockSize(uint32_t memory_type_index) const
+    {
+        auto heap_index = memory_properties_.memoryTypes[memory_type_index].heapIndex;
+        auto heap_size = memory_properties_.memoryHeaps[heap_index].size;
+
+        auto block_size = std::min(preferred_block_size, heap_size / heap_block_divisor);
+        return block_size & ~(VulkanMemoryBlock::region_granularity - 1);
+    }
+}
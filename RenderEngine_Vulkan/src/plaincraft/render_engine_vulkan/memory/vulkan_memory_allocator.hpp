@@ -0,0 +1,112 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_MEMORY_ALLOCATOR
+#define PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_MEMORY_ALLOCATOR
+
+#include "vulkan_memory_block.hpp"
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace plaincraft_render_engine_vulkan
+{
+    // Range of a memory block bound to a single buffer or image
+    struct VulkanMemoryAllocation
+    {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        void *mapped_data = nullptr;
+        VulkanMemoryBlock *block = nullptr;
+        uint32_t region = VulkanMemoryBlock::invalid_region;
+    };
+
+    // Suballocates buffers and images from a few large blocks per memory type instead of allocating device memory
+    // for each of them, which is slow and limited by maxMemoryAllocationCount. Linear and optimal resources get
+    // separate blocks so bufferImageGranularity never has to be considered between neighbors.
+    class VulkanMemoryAllocator
+    {
+    public:
+        enum class ResourceTiling
+        {
+            Linear,
+            Optimal
+        };
+
+        struct Statistics
+        {
+            uint32_t blocks_count;
+            uint32_t dedicated_blocks_count;
+            uint32_t allocations_count;
+            uint32_t free_regions_count;
+            VkDeviceSize capacity_bytes;
+            VkDeviceSize used_bytes;
+            VkDeviceSize largest_free_region;
+
+            // Share of the free memory not usable by an allocation as large as all of it, zero when it is contiguous
+            auto GetFragmentation() const -> float
+            {
+                auto free_bytes = capacity_bytes - used_bytes;
+                return free_bytes == 0 ? 0.0f : 1.0f - static_cast<float>(largest_free_region) / static_cast<float>(free_bytes);
+            }
+        };
+
+    private:
+        static constexpr VkDeviceSize preferred_block_size = 64 * 1024 * 1024;
+
+        // Small heaps such as the host visible device local one get smaller blocks
+        static constexpr VkDeviceSize heap_block_divisor = 8;
+
+        VkDevice device_;
+        VkPhysicalDeviceMemoryProperties memory_properties_;
+        VkDeviceSize non_coherent_atom_size_;
+
+        std::vector<std::vector<std::unique_ptr<VulkanMemoryBlock>>> pools_;
+
+        std::mutex allocator_mutex_;
+
+    public:
+        VulkanMemoryAllocator(VkPhysicalDevice physical_device, VkDevice device);
+
+        VulkanMemoryAllocator(const VulkanMemoryAllocator &other) = delete;
+        VulkanMemoryAllocator &operator=(const VulkanMemoryAllocator &other) = delete;
+
+        VulkanMemoryAllocation Allocate(const VkMemoryRequirements &memory_requirements, uint32_t memory_type_index, ResourceTiling tiling);
+        void Free(VulkanMemoryAllocation &allocation);
+
+        // Offset and size are relative to the allocation, the range is widened to nonCoherentAtomSize
+        VkResult Flush(const VulkanMemoryAllocation &allocation, VkDeviceSize size, VkDeviceSize offset);
+
+        Statistics GetStatistics();
+
+    private:
+        VkDeviceSize GetBlockSize(uint32_t memory_type_index) const;
+    };
+}
+
+#endif // PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_MEMORY_ALLOCATOR
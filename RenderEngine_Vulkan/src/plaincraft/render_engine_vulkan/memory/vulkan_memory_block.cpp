@@ -0,0 +1,330 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_memory_block.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace plaincraft_render_engine_vulkan
+{
+    VulkanMemoryBlock::VulkanMemoryBlock(VkDevice device, VkDeviceSize size, uint32_t memory_type_index, uint32_t pool_index, bool host_visible, bool dedicated)
+        : device_(device),
+          size_(size),
+          memory_type_index_(memory_type_index),
+          pool_index_(pool_index),
+          dedicated_(dedicated)
+    {
+        VkMemoryAllocateInfo allocate_info{};
+        allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocate_info.allocationSize = size_;
+        allocate_info.memoryTypeIndex = memory_type_index_;
+
+        if (vkAllocateMemory(device_, &allocate_info, nullptr, &memory_) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to allocate device memory block");
+        }
+
+        // Mapping the same memory twice is not allowed, so host visible blocks stay mapped for all of their resources
+        if (host_visible && vkMapMemory(device_, memory_, 0, VK_WHOLE_SIZE, 0, &mapped_data_) != VK_SUCCESS)
+        {
+            vkFreeMemory(device_, memory_, nullptr);
+            throw std::runtime_error("Failed to map device memory block");
+        }
+
+        for (auto &free_list : free_lists_)
+        {
+            free_list.fill(invalid_region);
+        }
+
+        // A dedicated block holds one resource spanning all of it, its only region is never put on the lists
+        auto whole = CreateRegion(0, size_);
+        if (!dedicated_)
+        {
+            InsertFreeRegion(whole);
+        }
+    }
+
+    VulkanMemoryBlock::~VulkanMemoryBlock()
+    {
+        if (mapped_data_ != nullptr)
+        {
+            vkUnmapMemory(device_, memory_);
+        }
+        vkFreeMemory(device_, memory_, nullptr);
+    }
+
+    bool VulkanMemoryBlock::Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize &offset, uint32_t &region)
+    {
+        if (dedicated_)
+        {
+            if (allocations_count_ > 0 || size > size_)
+            {
+                return false;
+            }
+
+            // The lists round sizes up to the next one, searching them could miss a region of exactly this size
+            used_bytes_ += regions_[0].size;
+            ++allocations_count_;
+
+            offset = 0;
+            region = 0;
+            return true;
+        }
+
+        alignment = std::max(alignment, region_granularity);
+
+        // Large enough to still fit after skipping the worst case padding in front of the aligned offset
+        auto found = FindFreeRegion(size + alignment - region_granularity);
+        if (found == invalid_region)
+        {
+            return false;
+        }
+
+        RemoveFreeRegion(found);
+
+        auto aligned_offset = (regions_[found].offset + alignment - 1) & ~(alignment - 1);
+        auto padding = aligned_offset - regions_[found].offset;
+        if (padding > 0)
+        {
+            auto front = CreateRegion(regions_[found].offset, padding);
+            auto previous = regions_[found].previous_physical;
+            regions_[front].previous_physical = previous;
+            regions_[front].next_physical = found;
+            if (previous != invalid_region)
+            {
+                regions_[previous].next_physical = front;
+            }
+            regions_[found].previous_physical = front;
+            regions_[found].offset = aligned_offset;
+            regions_[found].size -= padding;
+            InsertFreeRegion(front);
+        }
+
+        if (regions_[found].size > size)
+        {
+            auto back = CreateRegion(aligned_offset + size, regions_[found].size - size);
+            auto next = regions_[found].next_physical;
+            regions_[back].previous_physical = found;
+            regions_[back].next_physical = next;
+            if (next != invalid_region)
+            {
+                regions_[next].previous_physical = back;
+            }
+            regions_[found].next_physical = back;
+            regions_[found].size = size;
+            InsertFreeRegion(back);
+        }
+
+        used_bytes_ += size;
+        ++allocations_count_;
+
+        offset = aligned_offset;
+        region = found;
+        return true;
+    }
+
+    void VulkanMemoryBlock::Free(uint32_t region)
+    {
+        used_bytes_ -= regions_[region].size;
+        --allocations_count_;
+
+        if (dedicated_)
+        {
+            return;
+        }
+
+        auto previous = regions_[region].previous_physical;
+        if (previous != invalid_region && regions_[previous].free)
+        {
+            RemoveFreeRegion(previous);
+            regions_[previous].size += regions_[region].size;
+            DestroyRegion(region);
+            region = previous;
+        }
+
+        auto next = regions_[region].next_physical;
+        if (next != invalid_region && regions_[next].free)
+        {
+            RemoveFreeRegion(next);
+            regions_[region].size += regions_[next].size;
+            DestroyRegion(next);
+        }
+
+        InsertFreeRegion(region);
+    }
+
+    VkDeviceSize VulkanMemoryBlock::GetLargestFreeRegion() const
+    {
+        if (first_level_bitmap_ == 0)
+        {
+            return 0;
+        }
+
+        // Only the highest non-empty list can hold the largest region, but its sizes still differ within the list
+        auto first_level = static_cast<uint32_t>(std::bit_width(first_level_bitmap_)) - 1;
+        auto second_level = static_cast<uint32_t>(std::bit_width(second_level_bitmaps_[first_level])) - 1;
+
+        VkDeviceSize largest_size = 0;
+        for (auto region = free_lists_[first_level][second_level]; region != invalid_region; region = regions_[region].next_free)
+        {
+            largest_size = std::max(largest_size, regions_[region].size);
+        }
+        return largest_size;
+    }
+
+    uint32_t VulkanMemoryBlock::CreateRegion(VkDeviceSize offset, VkDeviceSize size)
+    {
+        Region region{offset, size, invalid_region, invalid_region, invalid_region, invalid_region, false};
+
+        if (!unused_regions_.empty())
+        {
+            auto index = unused_regions_.back();
+            unused_regions_.pop_back();
+            regions_[index] = region;
+            return index;
+        }
+
+        regions_.push_back(region);
+        return static_cast<uint32_t>(regions_.size() - 1);
+    }
+
+    void VulkanMemoryBlock::DestroyRegion(uint32_t region)
+    {
+        auto previous = regions_[region].previous_physical;
+        auto next = regions_[region].next_physical;
+        if (previous != invalid_region)
+        {
+            regions_[previous].next_physical = next;
+        }
+        if (next != invalid_region)
+        {
+            regions_[next].previous_physical = previous;
+        }
+        unused_regions_.push_back(region);
+    }
+
+    uint32_t VulkanMemoryBlock::FindFreeRegion(VkDeviceSize size) const
+    {
+        // Rounded up to the start of the next list, so any region of the list found is large enough
+        auto units = size / region_granularity;
+        auto top_bit = static_cast<uint32_t>(std::bit_width(units)) - 1;
+        if (top_bit >= second_level_bits)
+        {
+            units += (VkDeviceSize{1} << (top_bit - second_level_bits)) - 1;
+        }
+
+        uint32_t first_level, second_level;
+        MapSize(units * region_granularity, first_level, second_level);
+        if (first_level >= first_levels_count)
+        {
+            return invalid_region;
+        }
+
+        auto second_level_bitmap = second_level_bitmaps_[first_level] & (~0u << second_level);
+        if (second_level_bitmap == 0)
+        {
+            auto first_level_bitmap = first_level + 1 < first_levels_count ? first_level_bitmap_ & (~0u << (first_level + 1)) : 0u;
+            if (first_level_bitmap == 0)
+            {
+                return invalid_region;
+            }
+
+            first_level = static_cast<uint32_t>(std::countr_zero(first_level_bitmap));
+            second_level_bitmap = second_level_bitmaps_[first_level];
+        }
+
+        second_level = static_cast<uint32_t>(std::countr_zero(second_level_bitmap));
+        return free_lists_[first_level][second_level];
+    }
+
+    void VulkanMemoryBlock::InsertFreeRegion(uint32_t region)
+    {
+        uint32_t first_level, second_level;
+        MapSize(regions_[region].size, first_level, second_level);
+
+        auto head = free_lists_[first_level][second_level];
+        regions_[region].free = true;
+        regions_[region].previous_free = invalid_region;
+        regions_[region].next_free = head;
+        if (head != invalid_region)
+        {
+            regions_[head].previous_free = region;
+        }
+
+        free_lists_[first_level][second_level] = region;
+        second_level_bitmaps_[first_level] |= 1u << second_level;
+        first_level_bitmap_ |= 1u << first_level;
+        ++free_regions_count_;
+    }
+
+    void VulkanMemoryBlock::RemoveFreeRegion(uint32_t region)
+    {
+        uint32_t first_level, second_level;
+        MapSize(regions_[region].size, first_level, second_level);
+
+        auto previous = regions_[region].previous_free;
+        auto next = regions_[region].next_free;
+        if (previous != invalid_region)
+        {
+            regions_[previous].next_free = next;
+        }
+        if (next != invalid_region)
+        {
+            regions_[next].previous_free = previous;
+        }
+
+        if (free_lists_[first_level][second_level] == region)
+        {
+            free_lists_[first_level][second_level] = next;
+            if (next == invalid_region)
+            {
+                second_level_bitmaps_[first_level] &= ~(1u << second_level);
+                if (second_level_bitmaps_[first_level] == 0)
+                {
+                    first_level_bitmap_ &= ~(1u << first_level);
+                }
+            }
+        }
+
+        regions_[region].free = false;
+        --free_regions_count_;
+    }
+
+    void VulkanMemoryBlock::MapSize(VkDeviceSize size, uint32_t &first_level, uint32_t &second_level)
+    {
+        auto units = size / region_granularity;
+        first_level = static_cast<uint32_t>(std::bit_width(units)) - 1;
+        if (first_level < second_level_bits)
+        {
+            second_level = static_cast<uint32_t>(units << (second_level_bits - first_level)) & (second_levels_count - 1);
+        }
+        else
+        {
+            second_level = static_cast<uint32_t>(units >> (first_level - second_level_bits)) & (second_levels_count - 1);
+        }
+    }
+}
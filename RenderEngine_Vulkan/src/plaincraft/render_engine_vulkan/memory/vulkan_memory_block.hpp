@@ -0,0 +1,119 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_MEMORY_BLOCK
+#define PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_MEMORY_BLOCK
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace plaincraft_render_engine_vulkan
+{
+    // Single device memory allocation split between many resources with a two level segregated fit (TLSF)
+    // allocator. Free regions are kept in lists bucketed by the highest bit of their size and the next few bits,
+    // so finding a region large enough and merging it back with its neighbors are both constant time.
+    class VulkanMemoryBlock
+    {
+    public:
+        static constexpr uint32_t invalid_region = UINT32_MAX;
+
+        // Every offset and size within a block is a multiple of it
+        static constexpr VkDeviceSize region_granularity = 256;
+
+    private:
+        static constexpr uint32_t second_level_bits = 4;
+        static constexpr uint32_t second_levels_count = 1 << second_level_bits;
+        static constexpr uint32_t first_levels_count = 32;
+
+        struct Region
+        {
+            VkDeviceSize offset;
+            VkDeviceSize size;
+            uint32_t previous_physical;
+            uint32_t next_physical;
+            uint32_t previous_free;
+            uint32_t next_free;
+            bool free;
+        };
+
+        VkDevice device_;
+        VkDeviceMemory memory_ = VK_NULL_HANDLE;
+        VkDeviceSize size_;
+        uint32_t memory_type_index_;
+        uint32_t pool_index_;
+        bool dedicated_;
+        void *mapped_data_ = nullptr;
+
+        std::vector<Region> regions_;
+        std::vector<uint32_t> unused_regions_;
+
+        uint32_t first_level_bitmap_ = 0;
+        std::array<uint32_t, first_levels_count> second_level_bitmaps_{};
+        std::array<std::array<uint32_t, second_levels_count>, first_levels_count> free_lists_;
+
+        VkDeviceSize used_bytes_ = 0;
+        uint32_t allocations_count_ = 0;
+        uint32_t free_regions_count_ = 0;
+
+    public:
+        VulkanMemoryBlock(VkDevice device, VkDeviceSize size, uint32_t memory_type_index, uint32_t pool_index, bool host_visible, bool dedicated);
+        ~VulkanMemoryBlock();
+
+        VulkanMemoryBlock(const VulkanMemoryBlock &other) = delete;
+        VulkanMemoryBlock &operator=(const VulkanMemoryBlock &other) = delete;
+
+        // Size has to be a multiple of the region granularity and alignment a power of two
+        bool Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize &offset, uint32_t &region);
+        void Free(uint32_t region);
+
+        VkDeviceSize GetLargestFreeRegion() const;
+
+        auto GetMemory() const -> VkDeviceMemory { return memory_; }
+        auto GetSize() const -> VkDeviceSize { return size_; }
+        auto GetMemoryTypeIndex() const -> uint32_t { return memory_type_index_; }
+        auto GetPoolIndex() const -> uint32_t { return pool_index_; }
+        auto IsDedicated() const -> bool { return dedicated_; }
+        auto IsEmpty() const -> bool { return allocations_count_ == 0; }
+        auto GetMappedData() const -> void * { return mapped_data_; }
+        auto GetUsedBytes() const -> VkDeviceSize { return used_bytes_; }
+        auto GetAllocationsCount() const -> uint32_t { return allocations_count_; }
+        auto GetFreeRegionsCount() const -> uint32_t { return free_regions_count_; }
+
+    private:
+        uint32_t CreateRegion(VkDeviceSize offset, VkDeviceSize size);
+        void DestroyRegion(uint32_t region);
+
+        uint32_t FindFreeRegion(VkDeviceSize size) const;
+        void InsertFreeRegion(uint32_t region);
+        void RemoveFreeRegion(uint32_t region);
+
+        static void MapSize(VkDeviceSize size, uint32_t &first_level, uint32_t &second_level);
+    };
+}
+
+#endif // PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_MEMORY_BLOCK
@@ -56,8 +56,6 @@ namespace plaincraft_render_engine_vulkan
         const VulkanImageView& GetImageView() const;
 
     private:
-        void TransitionImageLayout(VkFormat format, VkImageLayout old_image_layout, VkImageLayout new_image_layout);
-
         void CreateTexture(void* image_data);
         void CreateSampler();
     };
@@ -0,0 +1,457 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_upload_manager.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace plaincraft_render_engine_vulkan
+{
+    VulkanUploadManager::VulkanUploadManager(const VulkanDevice &device)
+        : device_(device),
+          queue_(device.GetUploadQueue()),
+          queue_family_(device.GetUploadQueueFamily()),
+          graphics_queue_family_(device.GetGraphicsQueueFamily())
+    {
+        VkCommandPoolCreateInfo command_pool_info{};
+        command_pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        command_pool_info.queueFamilyIndex = queue_family_;
+        command_pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+        if (vkCreateCommandPool(device_.GetDevice(), &command_pool_info, nullptr, &command_pool_) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create upload command pool");
+        }
+
+        VkSemaphoreTypeCreateInfo semaphore_type_info{};
+        semaphore_type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        semaphore_type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        semaphore_type_info.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphore_info{};
+        semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphore_info.pNext = &semaphore_type_info;
+
+        if (vkCreateSemaphore(device_.GetDevice(), &semaphore_info, nullptr, &timeline_semaphore_) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create upload timeline semaphore");
+        }
+    }
+
+    VulkanUploadManager::~VulkanUploadManager()
+    {
+        vkDestroySemaphore(device_.GetDevice(), timeline_semaphore_, nullptr);
+        vkDestroyCommandPool(device_.GetDevice(), command_pool_, nullptr);
+    }
+
+    uint64_t VulkanUploadManager::CopyBuffer(std::shared_ptr<VulkanBuffer> source, VulkanBuffer &destination, VkDeviceSize destination_offset, VkDeviceSize size, bool after_previous_copies)
+    {
+        std::lock_guard lk(upload_mutex_);
+        auto command_buffer = BeginCommand();
+
+        // Barriers reach back over earlier submissions to the same queue too
+        if (after_previous_copies)
+        {
+            VkMemoryBarrier memory_barrier{};
+            memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            memory_barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+            vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+        }
+
+        VkBufferCopy copy_region{};
+        copy_region.srcOffset = 0;
+        copy_region.dstOffset = destination_offset;
+        copy_region.size = size;
+        vkCmdCopyBuffer(command_buffer, source->GetBuffer(), destination.GetBuffer(), 1, &copy_region);
+
+        if (TransfersOwnership() && destination.GetSharingMode() == VK_SHARING_MODE_EXCLUSIVE)
+        {
+            VkBufferMemoryBarrier release_barrier{};
+            release_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            release_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            release_barrier.dstAccessMask = 0;
+            release_barrier.srcQueueFamilyIndex = queue_family_;
+            release_barrier.dstQueueFamilyIndex = graphics_queue_family_;
+            release_barrier.buffer = destination.GetBuffer();
+            release_barrier.offset = destination_offset;
+            release_barrier.size = size;
+            vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &release_barrier, 0, nullptr);
+
+            auto acquire_barrier = release_barrier;
+            acquire_barrier.srcAccessMask = 0;
+            acquire_barrier.dstAccessMask = consumer_accesses;
+            recording_batch_.buffer_acquires.push_back(acquire_barrier);
+        }
+
+        recording_batch_.source_buffers.push_back(std::move(source));
+        return EndCommand();
+    }
+
+    uint64_t VulkanUploadManager::CopyBufferToImage(std::shared_ptr<VulkanBuffer> source, VkImage image, uint32_t width, uint32_t height)
+    {
+        std::lock_guard lk(upload_mutex_);
+        auto command_buffer = BeginCommand();
+
+        VkImageMemoryBarrier transfer_barrier{};
+        transfer_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        transfer_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        transfer_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        transfer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        transfer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        transfer_barrier.image = image;
+        transfer_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        transfer_barrier.subresourceRange.baseMipLevel = 0;
+        transfer_barrier.subresourceRange.levelCount = 1;
+        transfer_barrier.subresourceRange.baseArrayLayer = 0;
+        transfer_barrier.subresourceRange.layerCount = 1;
+        transfer_barrier.srcAccessMask = 0;
+        transfer_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &transfer_barrier);
+
+        VkBufferImageCopy image_copy_region{};
+        image_copy_region.bufferOffset = 0;
+        image_copy_region.bufferRowLength = 0;
+        image_copy_region.bufferImageHeight = 0;
+
+        image_copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        image_copy_region.imageSubresource.mipLevel = 0;
+        image_copy_region.imageSubresource.baseArrayLayer = 0;
+        image_copy_region.imageSubresource.layerCount = 1;
+
+        image_copy_region.imageOffset = {0, 0, 0};
+        image_copy_region.imageExtent = {width, height, 1};
+
+        vkCmdCopyBufferToImage(command_buffer, source->GetBuffer(), image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &image_copy_region);
+
+        // The semaphore signal makes the copy and the layout change visible to the graphics queue
+        auto shader_read_barrier = transfer_barrier;
+        shader_read_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        shader_read_barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        shader_read_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        shader_read_barrier.dstAccessMask = 0;
+
+        if (TransfersOwnership())
+        {
+            shader_read_barrier.srcQueueFamilyIndex = queue_family_;
+            shader_read_barrier.dstQueueFamilyIndex = graphics_queue_family_;
+
+            auto acquire_barrier = shader_read_barrier;
+            acquire_barrier.srcAccessMask = 0;
+            acquire_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            recording_batch_.image_acquires.push_back(acquire_barrier);
+        }
+
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &shader_read_barrier);
+
+        recording_batch_.source_buffers.push_back(std::move(source));
+        return EndCommand();
+    }
+
+    uint64_t VulkanUploadManager::Submit()
+    {
+        std::vector<std::shared_ptr<VulkanBuffer>> released_buffers;
+        uint64_t submitted_value;
+        {
+            std::lock_guard lk(upload_mutex_);
+            SubmitRecordingBatch();
+            released_buffers = ReleaseCompletedBatches();
+            submitted_value = submitted_value_;
+        }
+
+        return submitted_value;
+    }
+
+    bool VulkanUploadManager::RecordAcquireBarriers(VkCommandBuffer command_buffer, uint64_t &wait_value)
+    {
+        std::vector<VkBufferMemoryBarrier> buffer_barriers;
+        std::vector<VkImageMemoryBarrier> image_barriers;
+        {
+            std::lock_guard lk(upload_mutex_);
+
+            // A graphics submission waiting on a value that is never signaled would hang the queue
+            if (wait_value > submitted_value_)
+            {
+                SubmitRecordingBatch();
+            }
+
+            auto acquired_value = std::max(wait_value, GetCompletedValue());
+            for (auto &batch : submitted_batches_)
+            {
+                if (batch.value > acquired_value)
+                {
+                    break;
+                }
+
+                if (batch.buffer_acquires.empty() && batch.image_acquires.empty())
+                {
+                    continue;
+                }
+
+                buffer_barriers.insert(buffer_barriers.end(), batch.buffer_acquires.begin(), batch.buffer_acquires.end());
+                image_barriers.insert(image_barriers.end(), batch.image_acquires.begin(), batch.image_acquires.end());
+                batch.buffer_acquires.clear();
+                batch.image_acquires.clear();
+                wait_value = std::max(wait_value, batch.value);
+            }
+        }
+
+        if (buffer_barriers.empty() && image_barriers.empty())
+        {
+            return false;
+        }
+
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        if (vkBeginCommandBuffer(command_buffer, &begin_info) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to begin recording acquire barriers");
+        }
+
+        // Source stages match the stages the frame waits on the timeline semaphore with
+        vkCmdPipelineBarrier(command_buffer,
+                             consumer_stages,
+                             consumer_stages,
+                             0,
+                             0,
+                             nullptr,
+                             static_cast<uint32_t>(buffer_barriers.size()),
+                             buffer_barriers.data(),
+                             static_cast<uint32_t>(image_barriers.size()),
+                             image_barriers.data());
+
+        if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to record acquire barriers");
+        }
+
+        return true;
+    }
+
+    void VulkanUploadManager::Wait(uint64_t value)
+    {
+        if (GetCompletedValue() >= value)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard lk(upload_mutex_);
+            if (value > submitted_value_)
+            {
+                SubmitRecordingBatch();
+            }
+        }
+
+        VkSemaphoreWaitInfo wait_info{};
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &timeline_semaphore_;
+        wait_info.pValues = &value;
+
+        if (vkWaitSemaphores(device_.GetDevice(), &wait_info, UINT64_MAX) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to wait for uploads");
+        }
+    }
+
+    void VulkanUploadManager::ForgetBuffer(VkBuffer buffer)
+    {
+        std::lock_guard lk(upload_mutex_);
+        auto is_for_buffer = [buffer](const VkBufferMemoryBarrier &barrier)
+        { return barrier.buffer == buffer; };
+
+        std::erase_if(recording_batch_.buffer_acquires, is_for_buffer);
+        for (auto &batch : submitted_batches_)
+        {
+            std::erase_if(batch.buffer_acquires, is_for_buffer);
+        }
+    }
+
+    void VulkanUploadManager::ForgetImage(VkImage image)
+    {
+        std::lock_guard lk(upload_mutex_);
+        auto is_for_image = [image](const VkImageMemoryBarrier &barrier)
+        { return barrier.image == image; };
+
+        std::erase_if(recording_batch_.image_acquires, is_for_image);
+        for (auto &batch : submitted_batches_)
+        {
+            std::erase_if(batch.image_acquires, is_for_image);
+        }
+    }
+
+    void VulkanUploadManager::WaitIdle()
+    {
+        Wait(Submit());
+
+        std::vector<std::shared_ptr<VulkanBuffer>> released_buffers;
+        {
+            std::lock_guard lk(upload_mutex_);
+            released_buffers = ReleaseCompletedBatches();
+            submitted_batches_.clear();
+        }
+    }
+
+    uint64_t VulkanUploadManager::GetCompletedValue() const
+    {
+        uint64_t value = 0;
+        vkGetSemaphoreCounterValue(device_.GetDevice(), timeline_semaphore_, &value);
+        return value;
+    }
+
+    VkCommandBuffer VulkanUploadManager::BeginCommand()
+    {
+        if (recording_batch_.command_buffer != VK_NULL_HANDLE)
+        {
+            return recording_batch_.command_buffer;
+        }
+
+        if (free_command_buffers_.empty())
+        {
+            VkCommandBufferAllocateInfo allocate_info{};
+            allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocate_info.commandPool = command_pool_;
+            allocate_info.commandBufferCount = 1;
+
+            VkCommandBuffer command_buffer;
+            if (vkAllocateCommandBuffers(device_.GetDevice(), &allocate_info, &command_buffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("Failed to allocate upload command buffer");
+            }
+            free_command_buffers_.push_back(command_buffer);
+        }
+
+        recording_batch_.command_buffer = free_command_buffers_.back();
+        recording_batch_.value = submitted_value_ + 1;
+        free_command_buffers_.pop_back();
+
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        if (vkBeginCommandBuffer(recording_batch_.command_buffer, &begin_info) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to begin recording uploads");
+        }
+
+        return recording_batch_.command_buffer;
+    }
+
+    uint64_t VulkanUploadManager::EndCommand()
+    {
+        auto value = recording_batch_.value;
+        if (++recording_batch_.commands_count >= max_batch_commands_count)
+        {
+            SubmitRecordingBatch();
+        }
+        return value;
+    }
+
+    void VulkanUploadManager::SubmitRecordingBatch()
+    {
+        if (recording_batch_.command_buffer == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        if (vkEndCommandBuffer(recording_batch_.command_buffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to record uploads");
+        }
+
+        VkTimelineSemaphoreSubmitInfo timeline_submit_info{};
+        timeline_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_submit_info.signalSemaphoreValueCount = 1;
+        timeline_submit_info.pSignalSemaphoreValues = &recording_batch_.value;
+
+        VkSubmitInfo submit_info{};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.pNext = &timeline_submit_info;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &recording_batch_.command_buffer;
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores = &timeline_semaphore_;
+
+        {
+            // Without a dedicated transfer family the queue is shared with single time commands
+            std::unique_lock<std::mutex> queue_lock;
+            if (queue_ == device_.GetTransferQueue())
+            {
+                queue_lock = std::unique_lock(device_.GetTransferQueueMutex());
+            }
+
+            if (vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE) != VK_SUCCESS)
+            {
+                throw std::runtime_error("Failed to submit uploads");
+            }
+        }
+
+        submitted_value_ = recording_batch_.value;
+        submitted_batches_.push_back(std::move(recording_batch_));
+        recording_batch_ = Batch{};
+    }
+
+    std::vector<std::shared_ptr<VulkanBuffer>> VulkanUploadManager::ReleaseCompletedBatches()
+    {
+        std::vector<std::shared_ptr<VulkanBuffer>> released_buffers;
+
+        // Completed batches give their command buffers back right away, the acquires may have to wait for a frame
+        auto completed_value = GetCompletedValue();
+        for (auto &batch : submitted_batches_)
+        {
+            if (batch.value > completed_value)
+            {
+                break;
+            }
+
+            if (batch.command_buffer != VK_NULL_HANDLE)
+            {
+                free_command_buffers_.push_back(batch.command_buffer);
+                batch.command_buffer = VK_NULL_HANDLE;
+                std::move(batch.source_buffers.begin(), batch.source_buffers.end(), std::back_inserter(released_buffers));
+                batch.source_buffers.clear();
+            }
+        }
+
+        while (!submitted_batches_.empty())
+        {
+            auto &batch = submitted_batches_.front();
+            if (batch.command_buffer != VK_NULL_HANDLE || !batch.buffer_acquires.empty() || !batch.image_acquires.empty())
+            {
+                break;
+            }
+            submitted_batches_.pop_front();
+        }
+
+        // Destroyed by the caller once the lock is released
+        return released_buffers;
+    }
+}
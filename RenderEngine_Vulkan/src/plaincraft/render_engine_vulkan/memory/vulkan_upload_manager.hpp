@@ -0,0 +1,126 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_UPLOAD_MANAGER
+#define PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_UPLOAD_MANAGER
+
+#include "../device/vulkan_device.hpp"
+#include "vulkan_buffer.hpp"
+#include <vulkan/vulkan.h>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace plaincraft_render_engine_vulkan
+{
+    // Records the copies of any thread into one command buffer of the upload queue, every submitted batch signals
+    // the next value of a timeline semaphore. Nothing waits on the host, the graphics queue waits on the value
+    // a resource was uploaded with when it is drawn for the first time.
+    // When uploads run on a dedicated transfer family the batches release exclusive resources and the frame
+    // acquires them with RecordAcquireBarriers before using them.
+    class VulkanUploadManager final
+    {
+    public:
+        // Stages of the graphics queue consuming uploaded resources
+        static constexpr VkPipelineStageFlags consumer_stages = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+    private:
+        // A batch submits itself when it gets this large so loading without rendering frames keeps going
+        static constexpr uint32_t max_batch_commands_count = 256;
+
+        static constexpr VkAccessFlags consumer_accesses = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+        struct Batch
+        {
+            VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+            uint64_t value = 0;
+            uint32_t commands_count = 0;
+            std::vector<std::shared_ptr<VulkanBuffer>> source_buffers;
+            std::vector<VkBufferMemoryBarrier> buffer_acquires;
+            std::vector<VkImageMemoryBarrier> image_acquires;
+        };
+
+        const VulkanDevice& device_;
+        VkQueue queue_;
+        uint32_t queue_family_;
+        uint32_t graphics_queue_family_;
+
+        VkCommandPool command_pool_;
+        VkSemaphore timeline_semaphore_;
+
+        Batch recording_batch_;
+        std::deque<Batch> submitted_batches_;
+        std::vector<VkCommandBuffer> free_command_buffers_;
+        uint64_t submitted_value_ = 0;
+
+        std::mutex upload_mutex_;
+
+    public:
+        VulkanUploadManager(const VulkanDevice& device);
+
+        VulkanUploadManager(const VulkanUploadManager& other) = delete;
+        VulkanUploadManager& operator=(const VulkanUploadManager& other) = delete;
+
+        ~VulkanUploadManager();
+
+        // Both return the timeline value which signals the completion of the copy.
+        // Copies into the same destination are ordered only when asked for, the common case of filling
+        // distinct ranges does not need it.
+        uint64_t CopyBuffer(std::shared_ptr<VulkanBuffer> source, VulkanBuffer& destination, VkDeviceSize destination_offset, VkDeviceSize size, bool after_previous_copies = false);
+        uint64_t CopyBufferToImage(std::shared_ptr<VulkanBuffer> source, VkImage image, uint32_t width, uint32_t height);
+
+        // Submits the recorded copies, releases the batches the transfer queue is done with
+        uint64_t Submit();
+
+        // Records the acquiring half of the ownership transfers of the batches up to the wait value and of all
+        // completed ones, raises the wait value to cover them. Returns false when there was nothing to record.
+        bool RecordAcquireBarriers(VkCommandBuffer command_buffer, uint64_t& wait_value);
+
+        void Wait(uint64_t value);
+
+        // Drops the pending acquires of a resource about to be destroyed, barriers must not name destroyed handles
+        void ForgetBuffer(VkBuffer buffer);
+        void ForgetImage(VkImage image);
+
+        // Waits for every upload and drops what the batches kept alive, called before the device goes away
+        void WaitIdle();
+
+        uint64_t GetCompletedValue() const;
+
+        auto GetTimelineSemaphore() const -> VkSemaphore { return timeline_semaphore_; }
+        auto TransfersOwnership() const -> bool { return queue_family_ != graphics_queue_family_; }
+
+    private:
+        VkCommandBuffer BeginCommand();
+        uint64_t EndCommand();
+
+        void SubmitRecordingBatch();
+        std::vector<std::shared_ptr<VulkanBuffer>> ReleaseCompletedBatches();
+    };
+}
+
+#endif // PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_UPLOAD_MANAGER
@@ -0,0 +1,224 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_chunk_arena.hpp"
+#include "../memory/vulkan_upload_manager.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace plaincraft_render_engine_vulkan
+{
+    VulkanChunkArena::Allocation::Allocation(std::weak_ptr<VulkanChunkArena> arena, uint32_t first_vertex, uint32_t vertices_count, uint64_t upload_value)
+        : arena_(std::move(arena)), first_vertex_(first_vertex), vertices_count_(vertices_count), upload_value_(upload_value)
+    {
+    }
+
+    VulkanChunkArena::Allocation::~Allocation()
+    {
+        if (auto arena = arena_.lock())
+        {
+            arena->Free(first_vertex_, vertices_count_);
+        }
+    }
+
+    VulkanChunkArena::VulkanChunkArena(const VulkanDevice &device)
+        : device_(device), quad_index_buffer_(device)
+    {
+        Grow(initial_vertices_capacity);
+    }
+
+    std::shared_ptr<VulkanChunkArena::Allocation> VulkanChunkArena::Upload(const std::vector<ChunkVertex> &vertices)
+    {
+        auto vertices_count = static_cast<uint32_t>(vertices.size());
+        if (vertices_count == 0 || vertices_count % ChunkMesh::vertices_per_quad != 0)
+        {
+            throw std::runtime_error("Chunk arena accepts only whole quads");
+        }
+
+        auto staging_buffer = std::make_shared<VulkanBuffer>(VulkanBuffer::CreateFromVector(device_,
+                                                                                            vertices,
+                                                                                            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                                                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+
+        // The copy is recorded under the lock, so growing is always recorded after the copies into the old buffer
+        std::lock_guard lk(arena_mutex_);
+        auto first_vertex = Allocate(vertices_count);
+
+        // A reused range may still be overwritten by the pending growth copy with its stale contents
+        auto &upload_manager = device_.GetUploadManager();
+        auto after_growth = growth_value_ > upload_manager.GetCompletedValue();
+
+        auto upload_value = upload_manager.CopyBuffer(std::move(staging_buffer),
+                                                      *vertex_buffer_,
+                                                      static_cast<VkDeviceSize>(first_vertex) * sizeof(ChunkVertex),
+                                                      static_cast<VkDeviceSize>(vertices_count) * sizeof(ChunkVertex),
+                                                      after_growth);
+
+        return std::make_shared<Allocation>(weak_from_this(), first_vertex, vertices_count, upload_value);
+    }
+
+    std::shared_ptr<VulkanBuffer> VulkanChunkArena::GetVertexBuffer()
+    {
+        std::lock_guard lk(arena_mutex_);
+        return vertex_buffer_;
+    }
+
+    uint64_t VulkanChunkArena::GetVertexBufferUploadValue()
+    {
+        std::lock_guard lk(arena_mutex_);
+        return growth_value_;
+    }
+
+    std::shared_ptr<VulkanBuffer> VulkanChunkArena::GetIndexBuffer()
+    {
+        uint32_t max_quads_count;
+        {
+            std::lock_guard lk(arena_mutex_);
+            max_quads_count = max_quads_count_;
+        }
+        auto index_buffer = quad_index_buffer_.Reserve(max_quads_count);
+
+        std::lock_guard lk(arena_mutex_);
+        if (index_buffer != index_buffer_)
+        {
+            // Frames recorded before the growth still bind the old buffer, like the old vertex buffer
+            if (index_buffer_ != nullptr)
+            {
+                garbage_[garbage_index_].buffers.push_back(std::move(index_buffer_));
+            }
+            index_buffer_ = index_buffer;
+        }
+        return index_buffer;
+    }
+
+    void VulkanChunkArena::CollectGarbage()
+    {
+        std::lock_guard lk(arena_mutex_);
+
+        garbage_index_ = (garbage_index_ + 1) % retired_frames_count;
+        auto &garbage = garbage_[garbage_index_];
+        for (auto &[first_vertex, vertices_count] : garbage.ranges)
+        {
+            Release(first_vertex, vertices_count);
+        }
+        garbage.ranges.clear();
+        garbage.buffers.clear();
+    }
+
+    VulkanChunkArena::Statistics VulkanChunkArena::GetStatistics()
+    {
+        std::lock_guard lk(arena_mutex_);
+        return Statistics{
+            static_cast<VkDeviceSize>(used_vertices_count_) * sizeof(ChunkVertex),
+            static_cast<VkDeviceSize>(vertices_capacity_) * sizeof(ChunkVertex),
+            allocations_count_};
+    }
+
+    uint32_t VulkanChunkArena::Allocate(uint32_t vertices_count)
+    {
+        auto range = std::find_if(free_ranges_.begin(), free_ranges_.end(), [vertices_count](const auto &free_range)
+                                  { return free_range.second >= vertices_count; });
+
+        if (range == free_ranges_.end())
+        {
+            Grow(std::max(vertices_capacity_ * 2, vertices_capacity_ + vertices_count));
+            range = std::prev(free_ranges_.end());
+        }
+
+        auto first_vertex = range->first;
+        auto remaining_count = range->second - vertices_count;
+        free_ranges_.erase(range);
+        if (remaining_count > 0)
+        {
+            free_ranges_.emplace(first_vertex + vertices_count, remaining_count);
+        }
+
+        used_vertices_count_ += vertices_count;
+        ++allocations_count_;
+        max_quads_count_ = std::max(max_quads_count_, vertices_count / ChunkMesh::vertices_per_quad);
+
+        return first_vertex;
+    }
+
+    void VulkanChunkArena::Free(uint32_t first_vertex, uint32_t vertices_count)
+    {
+        std::lock_guard lk(arena_mutex_);
+        garbage_[garbage_index_].ranges.emplace_back(first_vertex, vertices_count);
+    }
+
+    void VulkanChunkArena::Release(uint32_t first_vertex, uint32_t vertices_count)
+    {
+        used_vertices_count_ -= vertices_count;
+        --allocations_count_;
+        AddFreeRange(first_vertex, vertices_count);
+    }
+
+    void VulkanChunkArena::AddFreeRange(uint32_t first_vertex, uint32_t vertices_count)
+    {
+        auto next = free_ranges_.lower_bound(first_vertex);
+        if (next != free_ranges_.end() && first_vertex + vertices_count == next->first)
+        {
+            vertices_count += next->second;
+            next = free_ranges_.erase(next);
+        }
+
+        if (next != free_ranges_.begin())
+        {
+            auto previous = std::prev(next);
+            if (previous->first + previous->second == first_vertex)
+            {
+                previous->second += vertices_count;
+                return;
+            }
+        }
+
+        free_ranges_.emplace(first_vertex, vertices_count);
+    }
+
+    void VulkanChunkArena::Grow(uint32_t vertices_capacity)
+    {
+        auto vertex_buffer = std::make_shared<VulkanBuffer>(device_,
+                                                            sizeof(ChunkVertex),
+                                                            vertices_capacity,
+                                                            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                                            1,
+                                                            VK_SHARING_MODE_CONCURRENT);
+
+        if (vertex_buffer_ != nullptr)
+        {
+            growth_value_ = device_.GetUploadManager().CopyBuffer(vertex_buffer_, *vertex_buffer, 0, vertex_buffer_->GetBufferSize(), true);
+
+            // Frames recorded before the growth still bind the old buffer
+            garbage_[garbage_index_].buffers.push_back(std::move(vertex_buffer_));
+        }
+
+        auto previous_capacity = vertices_capacity_;
+        vertex_buffer_ = std::move(vertex_buffer);
+        vertices_capacity_ = vertices_capacity;
+        AddFreeRange(previous_capacity, vertices_capacity - previous_capacity);
+    }
+}
@@ -0,0 +1,135 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_CHUNK_ARENA
+#define PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_CHUNK_ARENA
+
+#include "../device/vulkan_device.hpp"
+#include "../memory/vulkan_buffer.hpp"
+#include "vulkan_quad_index_buffer.hpp"
+#include <plaincraft_render_engine.hpp>
+#include <vulkan/vulkan.h>
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace plaincraft_render_engine_vulkan {
+    using namespace plaincraft_render_engine;
+
+    // One device local vertex buffer holding the geometry of every CPU meshed chunk, so all of them can be drawn
+    // with the same bindings. Freed ranges are reused only after the frames that could still read them have finished.
+    class VulkanChunkArena : public std::enable_shared_from_this<VulkanChunkArena> {
+    public:
+        // Vertices of one chunk section, returned to the arena when the last model using it is gone
+        class Allocation {
+        private:
+            std::weak_ptr<VulkanChunkArena> arena_;
+            uint32_t first_vertex_;
+            uint32_t vertices_count_;
+            uint64_t upload_value_;
+
+        public:
+            Allocation(std::weak_ptr<VulkanChunkArena> arena, uint32_t first_vertex, uint32_t vertices_count, uint64_t upload_value);
+            ~Allocation();
+
+            Allocation(const Allocation& other) = delete;
+            Allocation& operator=(const Allocation& other) = delete;
+
+            auto GetFirstVertex() const -> uint32_t { return first_vertex_; }
+            auto GetVerticesCount() const -> uint32_t { return vertices_count_; }
+            auto GetIndicesCount() const -> uint32_t { return vertices_count_ / ChunkMesh::vertices_per_quad * ChunkMesh::indices_per_quad; }
+            auto GetUploadValue() const -> uint64_t { return upload_value_; }
+        };
+
+        struct Statistics {
+            VkDeviceSize used_bytes;
+            VkDeviceSize capacity_bytes;
+            uint32_t allocations_count;
+        };
+
+    private:
+        static constexpr uint32_t initial_vertices_capacity = 4 * 1024 * 1024;
+
+        // Frames that may still be executing when a range is freed, one more than the frames in flight
+        static constexpr uint32_t retired_frames_count = 3;
+
+        struct Garbage {
+            std::vector<std::pair<uint32_t, uint32_t>> ranges;
+            std::vector<std::shared_ptr<VulkanBuffer>> buffers;
+        };
+
+        const VulkanDevice& device_;
+        VulkanQuadIndexBuffer quad_index_buffer_;
+
+        std::shared_ptr<VulkanBuffer> vertex_buffer_;
+
+        // Quad index buffer handed out to the last frame, retired like the vertex buffer when it gets replaced
+        std::shared_ptr<VulkanBuffer> index_buffer_;
+        uint32_t vertices_capacity_ = 0;
+        uint32_t used_vertices_count_ = 0;
+        uint32_t allocations_count_ = 0;
+        uint32_t max_quads_count_ = 0;
+
+        // Upload value of the copy which moved the contents into the current vertex buffer
+        uint64_t growth_value_ = 0;
+
+        // First vertex to vertices count of the unused ranges
+        std::map<uint32_t, uint32_t> free_ranges_;
+        std::array<Garbage, retired_frames_count> garbage_;
+        uint32_t garbage_index_ = 0;
+
+        std::mutex arena_mutex_;
+
+    public:
+        VulkanChunkArena(const VulkanDevice& device);
+
+        VulkanChunkArena(const VulkanChunkArena& other) = delete;
+        VulkanChunkArena& operator=(const VulkanChunkArena& other) = delete;
+
+        std::shared_ptr<Allocation> Upload(const std::vector<ChunkVertex>& vertices);
+
+        std::shared_ptr<VulkanBuffer> GetVertexBuffer();
+        uint64_t GetVertexBufferUploadValue();
+        std::shared_ptr<VulkanBuffer> GetIndexBuffer();
+        VulkanQuadIndexBuffer& GetQuadIndexBuffer() { return quad_index_buffer_; }
+
+        // Called once per frame, releases what the oldest retired frame was still allowed to read
+        void CollectGarbage();
+
+        Statistics GetStatistics();
+
+    private:
+        uint32_t Allocate(uint32_t vertices_count);
+        void Free(uint32_t first_vertex, uint32_t vertices_count);
+        void Release(uint32_t first_vertex, uint32_t vertices_count);
+        void AddFreeRange(uint32_t first_vertex, uint32_t vertices_count);
+        void Grow(uint32_t vertices_capacity);
+    };
+}
+
+#endif // PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_CHUNK_ARENA
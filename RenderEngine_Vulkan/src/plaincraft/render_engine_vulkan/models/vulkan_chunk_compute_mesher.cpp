@@ -0,0 +1,415 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_chunk_compute_mesher.hpp"
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+namespace plaincraft_render_engine_vulkan
+{
+    VulkanChunkComputeMesher::VulkanChunkComputeMesher(const VulkanDevice &device, VulkanQuadIndexBuffer &quad_index_buffer, const std::vector<char> &compute_shader_code)
+        : device_(device), quad_index_buffer_(quad_index_buffer)
+    {
+        CreateDescriptorPool();
+        CreatePipelineLayout();
+        pipeline_ = std::make_unique<VulkanComputePipeline>(device_, compute_shader_code, pipeline_layout_);
+        CreateSyncObjects();
+    }
+
+    VulkanChunkComputeMesher::~VulkanChunkComputeMesher()
+    {
+        auto vk_device = device_.GetDevice();
+
+        Wait(submitted_value_);
+        pending_dispatches_.clear();
+
+        vkDestroySemaphore(vk_device, timeline_semaphore_, nullptr);
+        vkDestroyCommandPool(vk_device, command_pool_, nullptr);
+        pipeline_.reset();
+        vkDestroyPipelineLayout(vk_device, pipeline_layout_, nullptr);
+        vkDestroyDescriptorPool(vk_device, descriptor_pool_, nullptr);
+        vkDestroyDescriptorSetLayout(vk_device, descriptor_set_layout_, nullptr);
+    }
+
+    std::unique_ptr<VulkanComputedChunkModel> VulkanChunkComputeMesher::Mesh(const ChunkVoxels &voxels)
+    {
+        auto faces_count = CountVisibleFaces(voxels);
+        if (faces_count == 0)
+        {
+            return std::make_unique<VulkanComputedChunkModel>(nullptr, nullptr, nullptr, VK_NULL_HANDLE, 0);
+        }
+
+        auto voxels_buffer = std::make_shared<VulkanBuffer>(VulkanBuffer::CreateFromVector(device_, voxels.GetBlocks(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+        auto block_table_buffer = std::make_shared<VulkanBuffer>(VulkanBuffer::CreateFromVector(device_, voxels.GetBlockTable(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+
+        // The shader counts the indices it writes into the draw command, everything else is known up front
+        DrawCommand draw_command{};
+        draw_command.draw.instanceCount = 1;
+        auto draw_command_buffer = std::make_shared<VulkanBuffer>(VulkanBuffer::CreateFromVector(device_, std::vector<DrawCommand>{draw_command}, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+
+        // Also a transfer source so the compute meshing test can read the vertices back
+        auto vertex_buffer = std::make_shared<VulkanBuffer>(
+            device_,
+            sizeof(ChunkVertex),
+            faces_count * ChunkMesh::vertices_per_quad,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        auto index_buffer = quad_index_buffer_.Reserve(faces_count);
+
+        uint64_t compute_value;
+        {
+            std::lock_guard lk(meshing_mutex_);
+            ReleaseCompletedDispatches();
+
+            // Bounds the command buffers and descriptor sets to what the pool was created for
+            if (pending_dispatches_.size() >= max_pending_dispatches)
+            {
+                Wait(pending_dispatches_.front().value);
+                ReleaseCompletedDispatches();
+            }
+
+            // Completed dispatches give their command buffer and descriptor set to the next ones
+            Dispatch dispatch{};
+            dispatch.command_buffer = AcquireCommandBuffer();
+            dispatch.descriptor_set = AcquireDescriptorSet();
+            dispatch.buffers = {voxels_buffer, block_table_buffer, draw_command_buffer, vertex_buffer};
+
+            UpdateDescriptorSet(dispatch.descriptor_set, *voxels_buffer, *block_table_buffer, *draw_command_buffer, *vertex_buffer);
+            compute_value = Submit(dispatch);
+            pending_dispatches_.push_back(std::move(dispatch));
+        }
+
+        return std::make_unique<VulkanComputedChunkModel>(vertex_buffer, draw_command_buffer, index_buffer, timeline_semaphore_, compute_value);
+    }
+
+    void VulkanChunkComputeMesher::Wait(uint64_t value)
+    {
+        if (value == 0 || GetCompletedValue() >= value)
+        {
+            return;
+        }
+
+        VkSemaphoreWaitInfo wait_info{};
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &timeline_semaphore_;
+        wait_info.pValues = &value;
+
+        if (vkWaitSemaphores(device_.GetDevice(), &wait_info, UINT64_MAX) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to wait for chunk meshing");
+        }
+    }
+
+    uint32_t VulkanChunkComputeMesher::CountVisibleFaces(const ChunkVoxels &voxels)
+    {
+        static_assert(ChunkVoxels::padded_size <= 32, "A padded row of voxels has to fit in one word");
+        constexpr uint32_t padded_size = ChunkVoxels::padded_size;
+        constexpr uint32_t height = ChunkVoxels::height;
+
+        // One bit per padded x for every (y, padded z) row, the same tests as the shader but 18 blocks at a time
+        std::vector<uint32_t> solid_rows(height * padded_size, 0);
+        std::vector<uint32_t> opaque_rows(height * padded_size, 0);
+
+        auto &blocks = voxels.GetBlocks();
+        auto &block_table = voxels.GetBlockTable();
+        for (uint32_t row = 0; row < height * padded_size; ++row)
+        {
+            for (uint32_t x = 0; x < padded_size; ++x)
+            {
+                auto index = row * padded_size + x;
+                auto block = (blocks[index / 2] >> (index % 2 * 16)) & 0xffff;
+                if (block == 0)
+                {
+                    continue;
+                }
+
+                solid_rows[row] |= 1u << x;
+                if (block_table[block * ChunkVoxels::block_table_stride + ChunkVoxels::block_table_stride - 1] & ChunkVoxels::opaque_flag)
+                {
+                    opaque_rows[row] |= 1u << x;
+                }
+            }
+        }
+
+        // The padding only hides faces, the blocks of the chunk are x in [1, size]
+        constexpr uint32_t chunk_mask = ((1u << ChunkVoxels::size) - 1) << 1;
+
+        uint32_t faces_count = 0;
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t z = 1; z <= ChunkVoxels::size; ++z)
+            {
+                auto row = y * padded_size + z;
+                auto solid = solid_rows[row] & chunk_mask;
+                if (solid == 0)
+                {
+                    continue;
+                }
+
+                // The world bottom and top are closed like in the shader
+                auto below = y > 0 ? opaque_rows[row - padded_size] : ~0u;
+                auto above = y + 1 < height ? opaque_rows[row + padded_size] : ~0u;
+
+                faces_count += std::popcount(solid & ~above);
+                faces_count += std::popcount(solid & ~below);
+                faces_count += std::popcount(solid & ~(opaque_rows[row] << 1));
+                faces_count += std::popcount(solid & ~(opaque_rows[row] >> 1));
+                faces_count += std::popcount(solid & ~opaque_rows[row - 1]);
+                faces_count += std::popcount(solid & ~opaque_rows[row + 1]);
+            }
+        }
+
+        return faces_count;
+    }
+
+    void VulkanChunkComputeMesher::CreateDescriptorPool()
+    {
+        auto vk_device = device_.GetDevice();
+
+        std::array<VkDescriptorSetLayoutBinding, bindings_count> layout_bindings{};
+        for (uint32_t binding = 0; binding < bindings_count; ++binding)
+        {
+            layout_bindings[binding].binding = binding;
+            layout_bindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            layout_bindings[binding].descriptorCount = 1;
+            layout_bindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+
+        VkDescriptorSetLayoutCreateInfo descriptor_set_layout_info{};
+        descriptor_set_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        descriptor_set_layout_info.bindingCount = bindings_count;
+        descriptor_set_layout_info.pBindings = layout_bindings.data();
+
+        if (vkCreateDescriptorSetLayout(vk_device, &descriptor_set_layout_info, nullptr, &descriptor_set_layout_) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create descriptor set layout");
+        }
+
+        // Every pending dispatch holds one set, they are never freed back to the pool but reused
+        VkDescriptorPoolSize pool_size{};
+        pool_size.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        pool_size.descriptorCount = bindings_count * max_pending_dispatches;
+
+        VkDescriptorPoolCreateInfo descriptor_pool_info{};
+        descriptor_pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        descriptor_pool_info.poolSizeCount = 1;
+        descriptor_pool_info.pPoolSizes = &pool_size;
+        descriptor_pool_info.maxSets = max_pending_dispatches;
+
+        if (vkCreateDescriptorPool(vk_device, &descriptor_pool_info, nullptr, &descriptor_pool_) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create descriptor pool");
+        }
+    }
+
+    void VulkanChunkComputeMesher::CreatePipelineLayout()
+    {
+        VkPipelineLayoutCreateInfo pipeline_layout_info{};
+        pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipeline_layout_info.setLayoutCount = 1;
+        pipeline_layout_info.pSetLayouts = &descriptor_set_layout_;
+
+        if (vkCreatePipelineLayout(device_.GetDevice(), &pipeline_layout_info, nullptr, &pipeline_layout_) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create pipeline layout");
+        }
+    }
+
+    void VulkanChunkComputeMesher::CreateSyncObjects()
+    {
+        auto vk_device = device_.GetDevice();
+
+        // Dispatches run on the second graphics family queue, every family that draws can also dispatch
+        VkCommandPoolCreateInfo command_pool_info{};
+        command_pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        command_pool_info.queueFamilyIndex = device_.GetGraphicsQueueFamily();
+        command_pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+        if (vkCreateCommandPool(vk_device, &command_pool_info, nullptr, &command_pool_) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create chunk meshing command pool");
+        }
+
+        VkSemaphoreTypeCreateInfo semaphore_type_info{};
+        semaphore_type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        semaphore_type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        semaphore_type_info.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphore_info{};
+        semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphore_info.pNext = &semaphore_type_info;
+
+        if (vkCreateSemaphore(vk_device, &semaphore_info, nullptr, &timeline_semaphore_) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create chunk meshing timeline semaphore");
+        }
+    }
+
+    VkCommandBuffer VulkanChunkComputeMesher::AcquireCommandBuffer()
+    {
+        if (!free_command_buffers_.empty())
+        {
+            auto command_buffer = free_command_buffers_.back();
+            free_command_buffers_.pop_back();
+            return command_buffer;
+        }
+
+        VkCommandBufferAllocateInfo allocate_info{};
+        allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocate_info.commandPool = command_pool_;
+        allocate_info.commandBufferCount = 1;
+
+        VkCommandBuffer command_buffer;
+        if (vkAllocateCommandBuffers(device_.GetDevice(), &allocate_info, &command_buffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to allocate chunk meshing command buffer");
+        }
+        return command_buffer;
+    }
+
+    VkDescriptorSet VulkanChunkComputeMesher::AcquireDescriptorSet()
+    {
+        if (!free_descriptor_sets_.empty())
+        {
+            auto descriptor_set = free_descriptor_sets_.back();
+            free_descriptor_sets_.pop_back();
+            return descriptor_set;
+        }
+
+        VkDescriptorSetAllocateInfo descriptor_set_allocate_info{};
+        descriptor_set_allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        descriptor_set_allocate_info.descriptorPool = descriptor_pool_;
+        descriptor_set_allocate_info.descriptorSetCount = 1;
+        descriptor_set_allocate_info.pSetLayouts = &descriptor_set_layout_;
+
+        VkDescriptorSet descriptor_set;
+        if (vkAllocateDescriptorSets(device_.GetDevice(), &descriptor_set_allocate_info, &descriptor_set) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to allocate descriptor set");
+        }
+        return descriptor_set;
+    }
+
+    void VulkanChunkComputeMesher::UpdateDescriptorSet(VkDescriptorSet descriptor_set, VulkanBuffer &voxels_buffer, VulkanBuffer &block_table_buffer, VulkanBuffer &draw_command_buffer, VulkanBuffer &vertex_buffer)
+    {
+        std::array<VkDescriptorBufferInfo, bindings_count> buffer_infos{{
+            {voxels_buffer.GetBuffer(), 0, VK_WHOLE_SIZE},
+            {block_table_buffer.GetBuffer(), 0, VK_WHOLE_SIZE},
+            {draw_command_buffer.GetBuffer(), 0, VK_WHOLE_SIZE},
+            {vertex_buffer.GetBuffer(), 0, VK_WHOLE_SIZE},
+        }};
+
+        std::array<VkWriteDescriptorSet, bindings_count> descriptor_writes{};
+        for (uint32_t binding = 0; binding < bindings_count; ++binding)
+        {
+            descriptor_writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_writes[binding].dstSet = descriptor_set;
+            descriptor_writes[binding].dstBinding = binding;
+            descriptor_writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            descriptor_writes[binding].descriptorCount = 1;
+            descriptor_writes[binding].pBufferInfo = &buffer_infos[binding];
+        }
+
+        vkUpdateDescriptorSets(device_.GetDevice(), bindings_count, descriptor_writes.data(), 0, nullptr);
+    }
+
+    uint64_t VulkanChunkComputeMesher::Submit(Dispatch &dispatch)
+    {
+        auto command_buffer = dispatch.command_buffer;
+
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        if (vkBeginCommandBuffer(command_buffer, &begin_info) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to begin recording chunk meshing");
+        }
+
+        pipeline_->Bind(command_buffer);
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout_, 0, 1, &dispatch.descriptor_set, 0, nullptr);
+
+        // One workgroup covers a 16x16 layer of the chunk, the shader hardcodes both dimensions
+        static_assert(ChunkVoxels::size == 16, "The chunk mesh shader expects 16 blocks wide chunks");
+        static_assert(ChunkVoxels::height == 64, "The chunk mesh shader expects 64 blocks high chunks");
+        vkCmdDispatch(command_buffer, 1, ChunkVoxels::height, 1);
+
+        if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to record chunk meshing");
+        }
+
+        // The semaphore signal makes the vertices and the draw command available to the frame waiting on it
+        dispatch.value = submitted_value_ + 1;
+
+        VkTimelineSemaphoreSubmitInfo timeline_submit_info{};
+        timeline_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_submit_info.signalSemaphoreValueCount = 1;
+        timeline_submit_info.pSignalSemaphoreValues = &dispatch.value;
+
+        VkSubmitInfo submit_info{};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.pNext = &timeline_submit_info;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &command_buffer;
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores = &timeline_semaphore_;
+
+        {
+            std::lock_guard lk(device_.GetTransferQueueMutex());
+            if (vkQueueSubmit(device_.GetTransferQueue(), 1, &submit_info, VK_NULL_HANDLE) != VK_SUCCESS)
+            {
+                throw std::runtime_error("Failed to submit chunk meshing");
+            }
+        }
+
+        submitted_value_ = dispatch.value;
+        return dispatch.value;
+    }
+
+    void VulkanChunkComputeMesher::ReleaseCompletedDispatches()
+    {
+        auto completed_value = GetCompletedValue();
+        while (!pending_dispatches_.empty() && pending_dispatches_.front().value <= completed_value)
+        {
+            auto &dispatch = pending_dispatches_.front();
+            free_command_buffers_.push_back(dispatch.command_buffer);
+            free_descriptor_sets_.push_back(dispatch.descriptor_set);
+            pending_dispatches_.pop_front();
+        }
+    }
+
+    uint64_t VulkanChunkComputeMesher::GetCompletedValue() const
+    {
+        uint64_t value = 0;
+        vkGetSemaphoreCounterValue(device_.GetDevice(), timeline_semaphore_, &value);
+        return value;
+    }
+}
@@ -0,0 +1,116 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_CHUNK_COMPUTE_MESHER
+#define PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_CHUNK_COMPUTE_MESHER
+
+#include "../device/vulkan_device.hpp"
+#include "../memory/vulkan_buffer.hpp"
+#include "../pipeline/vulkan_compute_pipeline.hpp"
+#include "vulkan_computed_chunk_model.hpp"
+#include "vulkan_quad_index_buffer.hpp"
+#include <plaincraft_render_engine.hpp>
+#include <vulkan/vulkan.h>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace plaincraft_render_engine_vulkan {
+    using namespace plaincraft_render_engine;
+
+    // Extracts the visible faces of chunk voxels with the chunk mesh compute shader.
+    // The faces are counted on the host from opacity bit rows of the voxels, so the vertex buffer gets its exact size and
+    // a single dispatch writes the vertices along with the indirect draw command. Dispatches are submitted without
+    // waiting, each signals the next value of a timeline semaphore which the frame drawing the chunk waits on.
+    class VulkanChunkComputeMesher {
+    private:
+        static constexpr uint32_t bindings_count = 4;
+
+        // Dispatches in flight at once, meshing waits for the oldest one beyond that
+        static constexpr uint32_t max_pending_dispatches = 64;
+
+        // Layout of the DrawCommand buffer of the shader
+        struct DrawCommand {
+            VkDrawIndexedIndirectCommand draw;
+        };
+
+        // Everything a submitted dispatch uses, recycled once the semaphore reaches its value
+        struct Dispatch {
+            VkCommandBuffer command_buffer;
+            VkDescriptorSet descriptor_set;
+            uint64_t value;
+            std::vector<std::shared_ptr<VulkanBuffer>> buffers;
+        };
+
+        const VulkanDevice& device_;
+        VulkanQuadIndexBuffer& quad_index_buffer_;
+
+        VkDescriptorSetLayout descriptor_set_layout_;
+        VkDescriptorPool descriptor_pool_;
+        VkPipelineLayout pipeline_layout_;
+        std::unique_ptr<VulkanComputePipeline> pipeline_;
+
+        VkCommandPool command_pool_;
+        VkSemaphore timeline_semaphore_;
+        uint64_t submitted_value_ = 0;
+
+        std::deque<Dispatch> pending_dispatches_;
+        std::vector<VkCommandBuffer> free_command_buffers_;
+        std::vector<VkDescriptorSet> free_descriptor_sets_;
+
+        std::mutex meshing_mutex_;
+
+    public:
+        VulkanChunkComputeMesher(const VulkanDevice& device, VulkanQuadIndexBuffer& quad_index_buffer, const std::vector<char>& compute_shader_code);
+        ~VulkanChunkComputeMesher();
+
+        VulkanChunkComputeMesher(const VulkanChunkComputeMesher& other) = delete;
+        VulkanChunkComputeMesher& operator=(const VulkanChunkComputeMesher& other) = delete;
+
+        std::unique_ptr<VulkanComputedChunkModel> Mesh(const ChunkVoxels& voxels);
+
+        // Blocks until the dispatch signaling the value has finished, for readbacks outside of the frame
+        void Wait(uint64_t value);
+
+        static uint32_t CountVisibleFaces(const ChunkVoxels& voxels);
+
+    private:
+        void CreateDescriptorPool();
+        void CreatePipelineLayout();
+        void CreateSyncObjects();
+
+        VkCommandBuffer AcquireCommandBuffer();
+        VkDescriptorSet AcquireDescriptorSet();
+
+        void UpdateDescriptorSet(VkDescriptorSet descriptor_set, VulkanBuffer& voxels_buffer, VulkanBuffer& block_table_buffer, VulkanBuffer& draw_command_buffer, VulkanBuffer& vertex_buffer);
+        uint64_t Submit(Dispatch& dispatch);
+        void ReleaseCompletedDispatches();
+        uint64_t GetCompletedValue() const;
+    };
+}
+
+#endif // PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_CHUNK_COMPUTE_MESHER
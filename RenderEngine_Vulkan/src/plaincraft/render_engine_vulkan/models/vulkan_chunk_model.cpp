@@ -0,0 +1,101 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_chunk_model.hpp"
+#include <algorithm>
+
+namespace plaincraft_render_engine_vulkan
+{
+    VulkanChunkModel::VulkanChunkModel(VulkanChunkArena &chunk_arena, std::shared_ptr<ChunkMesh const> mesh, const VulkanChunkModel *previous_model)
+        : chunk_arena_(chunk_arena), sections_(mesh->GetSectionsCount())
+    {
+        for (uint32_t section_index = 0; section_index < mesh->GetSectionsCount(); ++section_index)
+        {
+            if (!mesh->IsSectionUpdated(section_index))
+            {
+                if (previous_model != nullptr && section_index < previous_model->sections_.size())
+                {
+                    sections_[section_index] = previous_model->sections_[section_index];
+                }
+            }
+            else if (!mesh->GetSectionVertices(section_index).empty())
+            {
+                sections_[section_index] = chunk_arena_.Upload(mesh->GetSectionVertices(section_index));
+            }
+        }
+    }
+
+    void VulkanChunkModel::AppendDrawCommands(std::vector<VkDrawIndexedIndirectCommand> &draw_commands, uint32_t draw_index) const
+    {
+        for (auto &section : sections_)
+        {
+            if (section == nullptr)
+            {
+                continue;
+            }
+
+            VkDrawIndexedIndirectCommand draw_command{};
+            draw_command.indexCount = section->GetIndicesCount();
+            draw_command.instanceCount = 1;
+            draw_command.firstIndex = 0;
+            draw_command.vertexOffset = static_cast<int32_t>(section->GetFirstVertex());
+            draw_command.firstInstance = draw_index;
+            draw_commands.push_back(draw_command);
+        }
+    }
+
+    void VulkanChunkModel::Bind(VkCommandBuffer command_buffer)
+    {
+        VkBuffer buffers[] = {chunk_arena_.GetVertexBuffer()->GetBuffer()};
+        VkDeviceSize offsets[] = {0};
+        vkCmdBindVertexBuffers(command_buffer, 0, 1, buffers, offsets);
+        vkCmdBindIndexBuffer(command_buffer, chunk_arena_.GetIndexBuffer()->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+    }
+
+    void VulkanChunkModel::Draw(VkCommandBuffer command_buffer)
+    {
+        for (auto &section : sections_)
+        {
+            if (section != nullptr)
+            {
+                vkCmdDrawIndexed(command_buffer, section->GetIndicesCount(), 1, 0, static_cast<int32_t>(section->GetFirstVertex()), 0);
+            }
+        }
+    }
+
+    uint64_t VulkanChunkModel::GetUploadValue() const
+    {
+        uint64_t upload_value = 0;
+        for (auto &section : sections_)
+        {
+            if (section != nullptr)
+            {
+                upload_value = std::max(upload_value, section->GetUploadValue());
+            }
+        }
+        return upload_value;
+    }
+}
@@ -0,0 +1,62 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_CHUNK_MODEL
+#define PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_CHUNK_MODEL
+
+#include "vulkan_chunk_arena.hpp"
+#include "../scene/vulkan_drawable.hpp"
+#include <plaincraft_render_engine.hpp>
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <vector>
+
+namespace plaincraft_render_engine_vulkan {
+    using namespace plaincraft_render_engine;
+
+    // Chunk geometry in the packed chunk vertex format, drawn with the chunk pipeline.
+    // Every section has its own range of the chunk arena so that a remesh uploads only the updated sections.
+    class VulkanChunkModel : public Model, public VulkanDrawable {
+    private:
+        VulkanChunkArena& chunk_arena_;
+        std::vector<std::shared_ptr<VulkanChunkArena::Allocation>> sections_;
+
+    public:
+        VulkanChunkModel(VulkanChunkArena& chunk_arena, std::shared_ptr<ChunkMesh const> mesh, const VulkanChunkModel* previous_model);
+
+        VulkanChunkModel(const VulkanChunkModel& other) = delete;
+        VulkanChunkModel& operator=(const VulkanChunkModel& other) = delete;
+
+        // One command per non-empty section, draw_index is passed to the shader as the instance index
+        void AppendDrawCommands(std::vector<VkDrawIndexedIndirectCommand>& draw_commands, uint32_t draw_index) const;
+
+        void Bind(VkCommandBuffer command_buffer) override;
+        void Draw(VkCommandBuffer command_buffer) override;
+        uint64_t GetUploadValue() const override;
+    };
+}
+
+#endif // PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_CHUNK_MODEL
@@ -0,0 +1,63 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_computed_chunk_model.hpp"
+#include <utility>
+
+namespace plaincraft_render_engine_vulkan
+{
+    VulkanComputedChunkModel::VulkanComputedChunkModel(std::shared_ptr<VulkanBuffer> vertex_buffer, std::shared_ptr<VulkanBuffer> draw_command_buffer, std::shared_ptr<VulkanBuffer> index_buffer, VkSemaphore compute_semaphore, uint64_t compute_value)
+        : vertex_buffer_(std::move(vertex_buffer)), draw_command_buffer_(std::move(draw_command_buffer)), index_buffer_(std::move(index_buffer)),
+          compute_semaphore_(compute_semaphore), compute_value_(compute_value)
+    {
+    }
+
+    void VulkanComputedChunkModel::Bind(VkCommandBuffer command_buffer)
+    {
+        if (index_buffer_ != nullptr)
+        {
+            vkCmdBindIndexBuffer(command_buffer, index_buffer_->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+        }
+    }
+
+    void VulkanComputedChunkModel::Draw(VkCommandBuffer command_buffer)
+    {
+        if (vertex_buffer_ == nullptr)
+        {
+            return;
+        }
+
+        VkBuffer buffers[] = {vertex_buffer_->GetBuffer()};
+        VkDeviceSize offsets[] = {0};
+        vkCmdBindVertexBuffers(command_buffer, 0, 1, buffers, offsets);
+        vkCmdDrawIndexedIndirect(command_buffer, draw_command_buffer_->GetBuffer(), 0, 1, sizeof(VkDrawIndexedIndirectCommand));
+    }
+
+    uint64_t VulkanComputedChunkModel::GetUploadValue() const
+    {
+        return index_buffer_ != nullptr ? index_buffer_->GetUploadValue() : 0;
+    }
+}
@@ -0,0 +1,70 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_COMPUTED_CHUNK_MODEL
+#define PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_COMPUTED_CHUNK_MODEL
+
+#include "../memory/vulkan_buffer.hpp"
+#include "../scene/vulkan_drawable.hpp"
+#include <plaincraft_render_engine.hpp>
+#include <vulkan/vulkan.h>
+#include <memory>
+
+namespace plaincraft_render_engine_vulkan {
+    using namespace plaincraft_render_engine;
+
+    // Chunk geometry meshed by the chunk compute shader, drawn with the chunk pipeline.
+    // The indices count is only known to the device, so the chunk is drawn from the indirect command written by the shader.
+    // The frame drawing it waits for the compute semaphore to reach the value signaled by the meshing dispatch.
+    class VulkanComputedChunkModel : public Model, public VulkanDrawable {
+    private:
+        std::shared_ptr<VulkanBuffer> vertex_buffer_;
+        std::shared_ptr<VulkanBuffer> draw_command_buffer_;
+        std::shared_ptr<VulkanBuffer> index_buffer_;
+
+        VkSemaphore compute_semaphore_;
+        uint64_t compute_value_;
+
+    public:
+        VulkanComputedChunkModel(std::shared_ptr<VulkanBuffer> vertex_buffer, std::shared_ptr<VulkanBuffer> draw_command_buffer, std::shared_ptr<VulkanBuffer> index_buffer, VkSemaphore compute_semaphore, uint64_t compute_value);
+
+        VulkanComputedChunkModel(const VulkanComputedChunkModel& other) = delete;
+        VulkanComputedChunkModel& operator=(const VulkanComputedChunkModel& other) = delete;
+
+        void Bind(VkCommandBuffer command_buffer) override;
+        void Draw(VkCommandBuffer command_buffer) override;
+
+        uint64_t GetUploadValue() const override;
+
+        // Null when the chunk has no visible faces
+        auto GetVertexBuffer() const -> const std::shared_ptr<VulkanBuffer>& { return vertex_buffer_; }
+
+        auto GetComputeSemaphore() const -> VkSemaphore { return compute_semaphore_; }
+        auto GetComputeValue() const -> uint64_t { return compute_value_; }
+    };
+}
+
+#endif // PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_COMPUTED_CHUNK_MODEL
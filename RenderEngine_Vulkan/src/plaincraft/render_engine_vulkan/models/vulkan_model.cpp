@@ -26,6 +26,7 @@ SOFTWARE.
 
 #include "vulkan_model.hpp"
 #include "../memory/vulkan_texture.hpp"
+#include <algorithm>
 #include <cstring>
 
 namespace plaincraft_render_engine_vulkan
@@ -93,4 +94,9 @@ namespace plaincraft_render_engine_vulkan
         //vkCmdDraw(command_buffer, vertex_buffer_.GetInstanceCount(), 1, 0, 0);
         vkCmdDrawIndexed(command_buffer, index_buffer_.GetInstanceCount(), 1, 0, 0, 0);
     }
+
+    uint64_t VulkanModel::GetUploadValue() const
+    {
+        return std::max(vertex_buffer_.GetUploadValue(), index_buffer_.GetUploadValue());
+    }
 }
\ No newline at end of file
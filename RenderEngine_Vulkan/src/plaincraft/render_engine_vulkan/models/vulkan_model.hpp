@@ -36,7 +36,7 @@ SOFTWARE.
 namespace plaincraft_render_engine_vulkan {
     using namespace plaincraft_render_engine;
     
-    class VulkanModel : public Model, VulkanDrawable {
+    class VulkanModel : public Model, public VulkanDrawable {
     private:
         const VulkanDevice& device_;
 
@@ -55,6 +55,7 @@ namespace plaincraft_render_engine_vulkan {
 
         void Bind(VkCommandBuffer command_buffer) override;
         void Draw(VkCommandBuffer command_buffer) override;
+        uint64_t GetUploadValue() const override;
 
     private:
     };
@@ -26,11 +26,13 @@ SOFTWARE.
 
 #include "vulkan_models_factory.hpp"
 #include "vulkan_model.hpp"
+#include "vulkan_chunk_model.hpp"
+#include "../common.hpp"
 
 namespace plaincraft_render_engine_vulkan
 {
-    VulkanModelsFactory::VulkanModelsFactory(const VulkanDevice &device)
-        : device_(device)
+    VulkanModelsFactory::VulkanModelsFactory(const VulkanDevice &device, VulkanChunkArena &chunk_arena)
+        : device_(device), chunk_arena_(chunk_arena)
     {
     }
 
@@ -38,4 +40,20 @@ namespace plaincraft_render_engine_vulkan
     {
         return std::make_unique<VulkanModel>(VulkanModel(device_, mesh));
     }
+
+    std::unique_ptr<Model> VulkanModelsFactory::CreateChunkModel(std::shared_ptr<ChunkMesh const> mesh, std::shared_ptr<Model> previous_model)
+    {
+        if (mesh->GetVoxels() != nullptr)
+        {
+            std::call_once(chunk_compute_mesher_flag_, [this]()
+                           {
+                               auto compute_shader_code = read_file_raw(PLAINCRAFT_SHADERS_DIRECTORY "/chunk_mesh_comp.spv");
+                               chunk_compute_mesher_ = std::make_unique<VulkanChunkComputeMesher>(device_, chunk_arena_.GetQuadIndexBuffer(), compute_shader_code);
+                           });
+            return chunk_compute_mesher_->Mesh(*mesh->GetVoxels());
+        }
+
+        auto previous_chunk_model = dynamic_cast<VulkanChunkModel *>(previous_model.get());
+        return std::make_unique<VulkanChunkModel>(chunk_arena_, mesh, previous_chunk_model);
+    }
 }
\ No newline at end of file
@@ -26,6 +26,10 @@ SOFTWARE.
 
 #include <plaincraft_render_engine.hpp>
 #include "../device/vulkan_device.hpp"
+#include "vulkan_chunk_arena.hpp"
+#include "vulkan_chunk_compute_mesher.hpp"
+#include <memory>
+#include <mutex>
 
 namespace plaincraft_render_engine_vulkan {
     using namespace plaincraft_render_engine;
@@ -33,10 +37,16 @@ namespace plaincraft_render_engine_vulkan {
     class VulkanModelsFactory : public ModelsFactory {
     private:
         const VulkanDevice& device_;
+        VulkanChunkArena& chunk_arena_;
+
+        // Created with the first chunk meshed on the device, so the shader is only required when the backend is used
+        std::unique_ptr<VulkanChunkComputeMesher> chunk_compute_mesher_;
+        std::once_flag chunk_compute_mesher_flag_;
 
     public:
-        VulkanModelsFactory(const VulkanDevice& device);
+        VulkanModelsFactory(const VulkanDevice& device, VulkanChunkArena& chunk_arena);
 
         std::unique_ptr<Model> CreateModel(std::shared_ptr<Mesh const> mesh) override;
+        std::unique_ptr<Model> CreateChunkModel(std::shared_ptr<ChunkMesh const> mesh, std::shared_ptr<Model> previous_model) override;
     };
 }
\ No newline at end of file
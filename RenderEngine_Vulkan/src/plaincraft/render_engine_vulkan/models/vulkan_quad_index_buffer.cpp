@@ -0,0 +1,86 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_quad_index_buffer.hpp"
+
+#include <plaincraft_render_engine.hpp>
+#include <vector>
+
+namespace plaincraft_render_engine_vulkan
+{
+    using namespace plaincraft_render_engine;
+
+    VulkanQuadIndexBuffer::VulkanQuadIndexBuffer(const VulkanDevice &device)
+        : device_(device)
+    {
+    }
+
+    std::shared_ptr<VulkanBuffer> VulkanQuadIndexBuffer::Reserve(uint32_t quads_count)
+    {
+        std::lock_guard lk(buffer_mutex_);
+
+        if (buffer_ == nullptr || quads_count > quads_capacity_)
+        {
+            auto quads_capacity = quads_capacity_ > 0 ? quads_capacity_ : initial_quads_capacity;
+            while (quads_capacity < quads_count)
+            {
+                quads_capacity *= 2;
+            }
+
+            Grow(quads_capacity);
+        }
+
+        return buffer_;
+    }
+
+    void VulkanQuadIndexBuffer::Grow(uint32_t quads_capacity)
+    {
+        std::vector<uint32_t> indices;
+        indices.reserve(static_cast<size_t>(quads_capacity) * ChunkMesh::indices_per_quad);
+
+        for (uint32_t i = 0; i < quads_capacity; ++i)
+        {
+            indices.push_back(2 + 4 * i);
+            indices.push_back(1 + 4 * i);
+            indices.push_back(0 + 4 * i);
+
+            indices.push_back(2 + 4 * i);
+            indices.push_back(0 + 4 * i);
+            indices.push_back(3 + 4 * i);
+        }
+
+        buffer_ = std::make_shared<VulkanBuffer>(
+            VulkanBuffer::MoveBuffer(device_,
+                                     VulkanBuffer::CreateFromVector(
+                                         device_,
+                                         indices,
+                                         VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+                                     VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+        quads_capacity_ = quads_capacity;
+    }
+}
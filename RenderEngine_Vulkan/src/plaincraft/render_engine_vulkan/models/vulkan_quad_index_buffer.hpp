@@ -0,0 +1,62 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_QUAD_INDEX_BUFFER
+#define PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_QUAD_INDEX_BUFFER
+
+#include "../device/vulkan_device.hpp"
+#include "../memory/vulkan_buffer.hpp"
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <mutex>
+
+namespace plaincraft_render_engine_vulkan {
+    // Device local index buffer with the quad pattern, shared by every chunk model.
+    // Growing replaces the buffer. Computed chunk models keep the buffer they were created with alive,
+    // the chunk arena retires the one its frames bind until they have finished.
+    class VulkanQuadIndexBuffer {
+    private:
+        static constexpr uint32_t initial_quads_capacity = 16384;
+
+        const VulkanDevice& device_;
+        std::shared_ptr<VulkanBuffer> buffer_;
+        uint32_t quads_capacity_ = 0;
+        std::mutex buffer_mutex_;
+
+    public:
+        VulkanQuadIndexBuffer(const VulkanDevice& device);
+
+        VulkanQuadIndexBuffer(const VulkanQuadIndexBuffer& other) = delete;
+        VulkanQuadIndexBuffer& operator=(const VulkanQuadIndexBuffer& other) = delete;
+
+        std::shared_ptr<VulkanBuffer> Reserve(uint32_t quads_count);
+
+    private:
+        void Grow(uint32_t quads_capacity);
+    };
+}
+
+#endif // PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_QUAD_INDEX_BUFFER
@@ -0,0 +1,79 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "vulkan_compute_pipeline.hpp"
+#include <stdexcept>
+
+namespace plaincraft_render_engine_vulkan
+{
+    VulkanComputePipeline::VulkanComputePipeline(const VulkanDevice &device, const std::vector<char> &compute_shader_code, VkPipelineLayout pipeline_layout)
+        : device_(device)
+    {
+        auto vk_device = device_.GetDevice();
+
+        VkShaderModuleCreateInfo shader_module_info{};
+        shader_module_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        shader_module_info.codeSize = compute_shader_code.size();
+        shader_module_info.pCode = reinterpret_cast<const uint32_t *>(compute_shader_code.data());
+
+        VkShaderModule compute_shader_module;
+        if (vkCreateShaderModule(vk_device, &shader_module_info, nullptr, &compute_shader_module) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create shader module");
+        }
+
+        VkPipelineShaderStageCreateInfo compute_shader_stage_info{};
+        compute_shader_stage_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        compute_shader_stage_info.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        compute_shader_stage_info.module = compute_shader_module;
+        compute_shader_stage_info.pName = "main";
+
+        VkComputePipelineCreateInfo pipeline_info{};
+        pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipeline_info.stage = compute_shader_stage_info;
+        pipeline_info.layout = pipeline_layout;
+        pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
+        pipeline_info.basePipelineIndex = -1;
+
+        auto result = vkCreateComputePipelines(vk_device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &compute_pipeline_);
+        vkDestroyShaderModule(vk_device, compute_shader_module, nullptr);
+
+        if (result != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create compute pipeline");
+        }
+    }
+
+    VulkanComputePipeline::~VulkanComputePipeline()
+    {
+        vkDestroyPipeline(device_.GetDevice(), compute_pipeline_, nullptr);
+    }
+
+    void VulkanComputePipeline::Bind(VkCommandBuffer command_buffer)
+    {
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute_pipeline_);
+    }
+}
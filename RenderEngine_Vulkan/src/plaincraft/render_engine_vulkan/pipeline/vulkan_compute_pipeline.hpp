@@ -24,36 +24,32 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
-#ifndef PLAINCRAFT_CORE_BLOCK
-#define PLAINCRAFT_CORE_BLOCK
+#ifndef PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_COMPUTE_PIPELINE
+#define PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_COMPUTE_PIPELINE
 
-#include "../game_object.hpp"
-#include <utility>
+#include "../device/vulkan_device.hpp"
+#include <vulkan/vulkan.h>
+#include <vector>
 
-namespace plaincraft_core
-{
-    class Map;
-    class Chunk;
+namespace plaincraft_render_engine_vulkan {
+    class VulkanComputePipeline {
+    private:
+        const VulkanDevice& device_;
+
+        VkPipeline compute_pipeline_;
 
-    class Block : public GameObject
-    {
     public:
-        struct TextureCoordinates {
-            std::pair<int, int> top, bottom, left, right, front, back;
-        };
+        VulkanComputePipeline(const VulkanDevice& device, const std::vector<char>& compute_shader_code, VkPipelineLayout pipeline_layout);
 
-    friend class Map;
-    friend class Chunk;
+        ~VulkanComputePipeline();
 
-    private:
+        VulkanComputePipeline(const VulkanComputePipeline& other) = delete;
+        VulkanComputePipeline& operator=(const VulkanComputePipeline& other) = delete;
 
-    protected:
-
-    public:
-        Block();
+        void Bind(VkCommandBuffer command_buffer);
 
-        virtual const TextureCoordinates& GetTextureCoordinates() const = 0;
+        auto GetPipeline() const -> VkPipeline {return compute_pipeline_;}
     };
 }
 
-#endif // PLAINCRAFT_CORE_BLOCK
\ No newline at end of file
+#endif // PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_COMPUTE_PIPELINE
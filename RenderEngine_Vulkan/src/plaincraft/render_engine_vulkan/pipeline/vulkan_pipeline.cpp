@@ -68,15 +68,12 @@ namespace plaincraft_render_engine_vulkan
 
 		VkPipelineShaderStageCreateInfo shader_stages[] = {vertex_shader_stage_info, fragment_shader_stage_info};
 
-		auto binding_description = VertexUtils::GetBindingDescription();
-		auto attribute_description = VertexUtils::GetAttributeDescription();
-
 		VkPipelineVertexInputStateCreateInfo vertex_input_info{};
 		vertex_input_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-		vertex_input_info.vertexBindingDescriptionCount = 1;
-		vertex_input_info.pVertexBindingDescriptions = &binding_description;
-		vertex_input_info.vertexAttributeDescriptionCount = static_cast<uint32_t>(attribute_description.size());
-		vertex_input_info.pVertexAttributeDescriptions = attribute_description.data();
+		vertex_input_info.vertexBindingDescriptionCount = static_cast<uint32_t>(pipeline_config.binding_descriptions.size());
+		vertex_input_info.pVertexBindingDescriptions = pipeline_config.binding_descriptions.data();
+		vertex_input_info.vertexAttributeDescriptionCount = static_cast<uint32_t>(pipeline_config.attribute_descriptions.size());
+		vertex_input_info.pVertexAttributeDescriptions = pipeline_config.attribute_descriptions.data();
 		
 		VkDynamicState dynamic_states[] = {
 			VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_LINE_WIDTH
@@ -134,6 +131,10 @@ namespace plaincraft_render_engine_vulkan
 
 	void VulkanPipeline::CreateDefaultPipelineConfig(VulkanPipelineConfig &pipeline_config)
 	{
+		auto attribute_descriptions = VertexUtils::GetAttributeDescription();
+		pipeline_config.binding_descriptions = {VertexUtils::GetBindingDescription()};
+		pipeline_config.attribute_descriptions.assign(attribute_descriptions.begin(), attribute_descriptions.end());
+
 		pipeline_config.input_assembly_info.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
 		pipeline_config.input_assembly_info.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 		pipeline_config.input_assembly_info.primitiveRestartEnable = VK_FALSE;
@@ -47,6 +47,8 @@ namespace plaincraft_render_engine_vulkan {
         std::vector<VkDescriptorSetLayout> descriptor_set_layouts;
         VkRenderPass render_pass = nullptr;
         uint32_t subpass = 0;
+        std::vector<VkVertexInputBindingDescription> binding_descriptions;
+        std::vector<VkVertexInputAttributeDescription> attribute_descriptions;
     };
 }
 
@@ -63,4 +63,31 @@ namespace plaincraft_render_engine_vulkan {
 
 		return attribute_descriptions;
 	}
+
+	VkVertexInputBindingDescription VertexUtils::GetChunkBindingDescription() {
+		VkVertexInputBindingDescription binding_description{};
+
+		binding_description.binding = 0;
+		binding_description.stride = sizeof(ChunkVertex);
+		binding_description.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+		return binding_description;
+	}
+
+	std::array<VkVertexInputAttributeDescription, 2> VertexUtils::GetChunkAttributeDescription()
+	{
+		std::array<VkVertexInputAttributeDescription, 2> attribute_descriptions{};
+
+		attribute_descriptions[0].binding = 0;
+		attribute_descriptions[0].location = 0;
+		attribute_descriptions[0].format = VK_FORMAT_R32_UINT;
+		attribute_descriptions[0].offset = offsetof(ChunkVertex, position_normal_uv);
+
+		attribute_descriptions[1].binding = 0;
+		attribute_descriptions[1].location = 1;
+		attribute_descriptions[1].format = VK_FORMAT_R32_UINT;
+		attribute_descriptions[1].offset = offsetof(ChunkVertex, tile);
+
+		return attribute_descriptions;
+	}
 }
\ No newline at end of file
@@ -38,6 +38,9 @@ namespace plaincraft_render_engine_vulkan {
 		static VkVertexInputBindingDescription GetBindingDescription();
 
 		static std::array<VkVertexInputAttributeDescription, 4> GetAttributeDescription();
+
+		static VkVertexInputBindingDescription GetChunkBindingDescription();
+		static std::array<VkVertexInputAttributeDescription, 2> GetChunkAttributeDescription();
 	};
 }
 #endif // PLAINCRAFT_RENDER_ENGINE_VULKAN_VERTEX_UTILS
\ No newline at end of file
@@ -28,6 +28,7 @@ SOFTWARE.
 #define PLAINCRAFT_RENDER_ENGINE_VULKAN_VULKAN_DRAWABLE
 
 #include <vulkan/vulkan.h>
+#include <cstdint>
 
 namespace plaincraft_render_engine_vulkan
 {
@@ -36,6 +37,9 @@ namespace plaincraft_render_engine_vulkan
     public:
         virtual void Bind(VkCommandBuffer command_buffer) = 0;
         virtual void Draw(VkCommandBuffer command_buffer) = 0;
+
+        // Timeline value of the upload manager the frame drawing it has to wait for
+        virtual uint64_t GetUploadValue() const { return 0; }
     };
 }
 
@@ -25,15 +25,19 @@ SOFTWARE.
 */
 
 #include "vulkan_scene_renderer.hpp"
+#include "vertex_utils.hpp"
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <fstream>
 #include <glm\gtx\quaternion.hpp>
 
 namespace plaincraft_render_engine_vulkan
 {
-	VulkanSceneRenderer::VulkanSceneRenderer(VulkanDevice &device, VkRenderPass render_pass, VkExtent2D extent, size_t images_count, std::shared_ptr<Camera> camera)
+	VulkanSceneRenderer::VulkanSceneRenderer(VulkanDevice &device, VulkanChunkArena &chunk_arena, VkRenderPass render_pass, VkExtent2D extent, size_t images_count, std::shared_ptr<Camera> camera)
 		: SceneRenderer(camera),
 		  device_(device),
+		  chunk_arena_(chunk_arena),
 		  render_pass_(render_pass),
 		  extent_(extent),
 		  images_count_(images_count)
@@ -42,9 +46,20 @@ namespace plaincraft_render_engine_vulkan
 		VulkanPipelineConfig pipeline_config{};
 		descriptor_sets_.resize(images_count);
 
+		VkPhysicalDeviceProperties physical_device_properties;
+		vkGetPhysicalDeviceProperties(device_.GetPhysicalDevice(), &physical_device_properties);
+		min_uniform_buffer_alignment_ = physical_device_properties.limits.minUniformBufferOffsetAlignment;
+
+		frame_allocator_ = std::make_unique<VulkanFrameAllocator>(device_,
+																  images_count_,
+																  VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+
 		CreateDescriptorSetLayout();
 		CreateDescriptorPool();
-		RecreateEntitiesBuffers();
+		for (uint32_t i = 0; i < images_count_; ++i)
+		{
+			CreateFrameDescriptors(i);
+		}
 		CreatePipelineLayout();
 
 		VkViewport viewport{};
@@ -54,16 +69,26 @@ namespace plaincraft_render_engine_vulkan
 		auto vertex_shader_code = read_file_raw("F:\\Projekty\\Plaincraft\\Shaders\\Vulkan\\vert.spv");
 		auto fragment_shader_code = read_file_raw("F:\\Projekty\\Plaincraft\\Shaders\\Vulkan\\frag.spv");
 		pipeline_ = std::make_unique<VulkanPipeline>(device_, vertex_shader_code, fragment_shader_code, pipeline_config);
+
+		auto chunk_vertex_shader_code = read_file_raw("F:\\Projekty\\Plaincraft\\Shaders\\Vulkan\\chunk_vert.spv");
+		auto chunk_fragment_shader_code = read_file_raw("F:\\Projekty\\Plaincraft\\Shaders\\Vulkan\\chunk_frag.spv");
+		auto chunk_pipeline_config = pipeline_config;
+		auto chunk_attribute_descriptions = VertexUtils::GetChunkAttributeDescription();
+		chunk_pipeline_config.binding_descriptions = {VertexUtils::GetChunkBindingDescription()};
+		chunk_pipeline_config.attribute_descriptions.assign(chunk_attribute_descriptions.begin(), chunk_attribute_descriptions.end());
+		chunk_pipeline_ = std::make_unique<VulkanPipeline>(device_, chunk_vertex_shader_code, chunk_fragment_shader_code, chunk_pipeline_config);
+
+		auto chunk_indirect_vertex_shader_code = read_file_raw("F:\\Projekty\\Plaincraft\\Shaders\\Vulkan\\chunk_indirect_vert.spv");
+		auto chunk_indirect_pipeline_config = chunk_pipeline_config;
+		chunk_indirect_pipeline_config.descriptor_set_layouts = {chunk_draws_descriptor_set_layout_->GetDescriptorSetLayout(), material_descriptor_set_layout_->GetDescriptorSetLayout()};
+		chunk_indirect_pipeline_config.pipeline_layout = chunk_indirect_pipeline_layout_;
+		chunk_indirect_pipeline_ = std::make_unique<VulkanPipeline>(device_, chunk_indirect_vertex_shader_code, chunk_fragment_shader_code, chunk_indirect_pipeline_config);
 	}
 
 	VulkanSceneRenderer::~VulkanSceneRenderer()
 	{
 		vkDestroyPipelineLayout(device_.GetDevice(), pipeline_layout_, nullptr);
-
-		if (model_memory_ != nullptr)
-		{
-			_aligned_free(model_memory_);
-		}
+		vkDestroyPipelineLayout(device_.GetDevice(), chunk_indirect_pipeline_layout_, nullptr);
 	}
 
 	void VulkanSceneRenderer::BeginFrame(VulkanRendererFrameConfig &frame_config)
@@ -109,19 +134,26 @@ namespace plaincraft_render_engine_vulkan
 
 	void VulkanSceneRenderer::Render()
 	{
+		chunk_arena_.CollectGarbage();
+
+		auto memory_statistics = device_.GetMemoryAllocator().GetStatistics();
+		char memory_buffer[128];
+		std::snprintf(memory_buffer, sizeof(memory_buffer), "%.1f/%.1f MB, %u allocations in %u blocks (%u dedicated), %.0f%% fragmented",
+					  memory_statistics.used_bytes / (1024.0 * 1024.0),
+					  memory_statistics.capacity_bytes / (1024.0 * 1024.0),
+					  memory_statistics.allocations_count,
+					  memory_statistics.blocks_count,
+					  memory_statistics.dedicated_blocks_count,
+					  memory_statistics.GetFragmentation() * 100.0f);
+		LOGVALUE("device memory", memory_buffer);
+
 		if(drawables_list_.empty())
 		{
 			return;
 		}
 
-		if (drawables_list_.size() > buffers_instance_count_)
-		{
-			RecreateEntitiesBuffers();
-		}
-
 		auto &frame_config = *frame_config_;
 		auto command_buffer = frame_config.command_buffer;
-		pipeline_->Bind(command_buffer);
 
 		auto &descriptor_set = descriptor_sets_[frame_config.image_index];
 
@@ -129,49 +161,80 @@ namespace plaincraft_render_engine_vulkan
 		projection[1][1] *= -1;
 		glm::mat4 view = glm::lookAt(camera_->position, camera_->position + camera_->direction, camera_->up);
 
-		auto &view_projection_buffer = view_projection_buffers_[frame_config.image_index];
-		auto &model_buffer = model_buffers_[frame_config.image_index];
-		// auto &texture_images = descriptor_set.materials_descriptor_set;
-		auto alignment_size = view_projection_buffer->GetAlignmentSize();
+		CullDrawables(projection * view);
+
+		DrawablesGroups drawables_grouped;
+		DrawablesGroups chunks_grouped;
+
+		uint32_t visible_drawables_count = 0;
+		for (size_t d = 0; d < drawables_list_.size(); ++d)
+		{
+			if (drawables_visibility_[d] == 0)
+			{
+				continue;
+			}
+
+			auto &drawable = drawables_list_[d];
+			auto texture = drawable->GetTexture();
+			if (dynamic_cast<VulkanChunkModel *>(drawable->GetModel().get()) != nullptr)
+			{
+				chunks_grouped[texture].push_back(*drawable);
+				continue;
+			}
+
+			drawables_grouped[texture].push_back(*drawable);
+			++visible_drawables_count;
+		}
+
+		auto chunks_batches = CollectChunkDraws(chunks_grouped);
+
+		// Everything the frame writes is sized up front, so its buffer never changes while commands are recorded
+		auto alignment_size = (sizeof(ModelMatrix) + min_uniform_buffer_alignment_ - 1) & ~(min_uniform_buffer_alignment_ - 1);
+		auto required_size = sizeof(ViewProjectionMatrix) + min_uniform_buffer_alignment_ +
+							 alignment_size * visible_drawables_count + min_uniform_buffer_alignment_ +
+							 sizeof(ChunkDraw) * (chunk_draws_.size() + 1) +
+							 sizeof(VkDrawIndexedIndirectCommand) * (chunk_draw_commands_.size() + 1);
+
+		if (frame_allocator_->BeginFrame(frame_config.image_index, required_size))
+		{
+			CreateFrameDescriptors(frame_config.image_index);
+		}
+
+		char frame_buffer[64];
+		std::snprintf(frame_buffer, sizeof(frame_buffer), "%.1f/%.1f KB",
+					  required_size / 1024.0,
+					  frame_allocator_->GetCapacity() / 1024.0);
+		LOGVALUE("frame allocator", frame_buffer);
 
 		ViewProjectionMatrix vp_matrix{
 			view,
 			projection};
+		auto view_projection = frame_allocator_->Write(&vp_matrix, 1, min_uniform_buffer_alignment_);
+		auto view_projection_offset = static_cast<uint32_t>(view_projection.offset);
 
-		view_projection_buffer->Map(sizeof(ViewProjectionMatrix), 0);
-		view_projection_buffer->Write(&vp_matrix, sizeof(ViewProjectionMatrix), 0);
-		view_projection_buffer->Unmap();
-		// view_projection_buffer->Flush(sizeof(ViewProjectionMatrix), 0);
-
-		std::unordered_map<std::shared_ptr<Texture>, std::vector<std::reference_wrapper<Drawable>>> drawables_grouped;
+		RenderChunks(chunks_batches, view_projection_offset);
 
-		for (auto &drawable : drawables_list_)
+		if (visible_drawables_count == 0)
 		{
-			auto texture = drawable->GetTexture();
-			drawables_grouped[texture].push_back(*drawable);
+			return;
 		}
 
+		auto models = frame_allocator_->Allocate(alignment_size * visible_drawables_count, min_uniform_buffer_alignment_);
+
 		auto i = 0;
 		for (auto material_group : drawables_grouped)
 		{
 			for (auto &drawable : material_group.second)
 			{
-				auto color = drawable.get().GetColor();
-				auto model = drawable.get().GetModelMatrix();
-
-				auto offset = static_cast<uint32_t>(i) * alignment_size;
-				auto *model_matrix = reinterpret_cast<ModelMatrix *>((reinterpret_cast<uint64_t>(model_memory_) + (i * alignment_size)));
-				model_matrix->color = color;
-				model_matrix->model = model;
+				auto *model_matrix = reinterpret_cast<ModelMatrix *>(static_cast<char *>(models.data) + i * alignment_size);
+				model_matrix->color = drawable.get().GetColor();
+				model_matrix->model = drawable.get().GetModelMatrix();
 
 				++i;
 			}
 		}
 
-		model_buffer->Map(alignment_size * drawables_list_.size(), 0);
-		model_buffer->Write(model_memory_, alignment_size * drawables_list_.size(), 0);
-		model_buffer->Unmap();
-		// model_buffer->Flush(alignment_size * drawables_list_.size(), 0);
+		VulkanPipeline *bound_pipeline = nullptr;
 
 		i = 0;
 		for (auto material_group : drawables_grouped)
@@ -180,25 +243,42 @@ namespace plaincraft_render_engine_vulkan
 
 			if (material_group.first == nullptr)
 			{
+				i += material_group.second.size();
 				continue;
 			}
 
 			auto material_descriptor_set = descriptor_set.materials_descriptor_set[material_group.first];
 			std::vector<VkDescriptorSet> descriptor_sets = {mvp_descriptor_set, material_descriptor_set};
+			WaitForUpload(std::dynamic_pointer_cast<VulkanTexture>(material_group.first)->GetUploadValue());
 
 			for (auto &drawable : material_group.second)
 			{
-				uint32_t dynamic_offset = i * alignment_size;
+				auto model = drawable.get().GetModel();
+				auto vulkan_model = std::dynamic_pointer_cast<VulkanDrawable>(model);
+				WaitForUpload(vulkan_model->GetUploadValue());
+				auto computed_chunk_model = std::dynamic_pointer_cast<VulkanComputedChunkModel>(model);
+				if (computed_chunk_model != nullptr)
+				{
+					WaitForCompute(computed_chunk_model->GetComputeSemaphore(), computed_chunk_model->GetComputeValue());
+				}
+				auto is_chunk_model = std::dynamic_pointer_cast<VulkanChunkModel>(model) != nullptr || computed_chunk_model != nullptr;
+				auto pipeline = is_chunk_model ? chunk_pipeline_.get() : pipeline_.get();
+				if (pipeline != bound_pipeline)
+				{
+					pipeline->Bind(command_buffer);
+					bound_pipeline = pipeline;
+				}
+
+				uint32_t dynamic_offsets[] = {static_cast<uint32_t>(models.offset + i * alignment_size), view_projection_offset};
 				vkCmdBindDescriptorSets(command_buffer,
 										VK_PIPELINE_BIND_POINT_GRAPHICS,
 										pipeline_layout_,
 										0,
 										descriptor_sets.size(),
 										descriptor_sets.data(),
-										1,
-										&dynamic_offset);
+										2,
+										dynamic_offsets);
 
-				auto vulkan_model = std::dynamic_pointer_cast<VulkanModel>(drawable.get().GetModel());
 				vulkan_model->Bind(command_buffer);
 				vulkan_model->Draw(command_buffer);
 
@@ -207,6 +287,170 @@ namespace plaincraft_render_engine_vulkan
 		}
 	}
 
+	void VulkanSceneRenderer::CullDrawables(const glm::mat4 &view_projection)
+	{
+		culling_boxes_.Clear();
+		culling_boxes_drawables_.clear();
+		drawables_visibility_.assign(drawables_list_.size(), 1);
+
+		for (size_t d = 0; d < drawables_list_.size(); ++d)
+		{
+			auto &drawable = drawables_list_[d];
+			if (drawable->HasBounds())
+			{
+				auto position = drawable->GetPosition();
+				culling_boxes_.Add(position + drawable->GetBoundsMin(), position + drawable->GetBoundsMax());
+				culling_boxes_drawables_.push_back(static_cast<uint32_t>(d));
+			}
+		}
+
+		auto planes = FrustumCullingKernel::ExtractPlanes(view_projection);
+		auto visible_count = FrustumCullingKernel::CullBoxes(planes, culling_boxes_, culling_boxes_visibility_);
+
+		for (size_t b = 0; b < culling_boxes_drawables_.size(); ++b)
+		{
+			drawables_visibility_[culling_boxes_drawables_[b]] = culling_boxes_visibility_[b];
+		}
+
+		char buffer[64];
+		std::snprintf(buffer, sizeof(buffer), "%u visible, %u culled (%s)",
+					  visible_count,
+					  static_cast<uint32_t>(culling_boxes_.GetCount()) - visible_count,
+					  FrustumCullingKernel::GetInstructionSet());
+		LOGVALUE("frustum culling", buffer);
+	}
+
+	std::vector<VulkanSceneRenderer::ChunksBatch> VulkanSceneRenderer::CollectChunkDraws(const DrawablesGroups &chunks_grouped)
+	{
+		auto &descriptor_set = descriptor_sets_[frame_config_->image_index];
+
+		chunk_draws_.clear();
+		chunk_draw_commands_.clear();
+		std::vector<ChunksBatch> batches;
+
+		for (auto &[texture, drawables] : chunks_grouped)
+		{
+			if (texture == nullptr)
+			{
+				continue;
+			}
+
+			WaitForUpload(std::dynamic_pointer_cast<VulkanTexture>(texture)->GetUploadValue());
+
+			auto first_draw_command = static_cast<uint32_t>(chunk_draw_commands_.size());
+			for (auto &drawable : drawables)
+			{
+				auto chunk_model = std::dynamic_pointer_cast<VulkanChunkModel>(drawable.get().GetModel());
+				if (chunk_model == nullptr)
+				{
+					continue;
+				}
+
+				WaitForUpload(chunk_model->GetUploadValue());
+
+				auto draw_index = static_cast<uint32_t>(chunk_draws_.size());
+				chunk_draws_.push_back(ChunkDraw{glm::vec4(drawable.get().GetPosition(), 0.0f), glm::vec4(drawable.get().GetColor(), 1.0f)});
+				chunk_model->AppendDrawCommands(chunk_draw_commands_, draw_index);
+			}
+
+			auto draw_commands_count = static_cast<uint32_t>(chunk_draw_commands_.size()) - first_draw_command;
+			if (draw_commands_count > 0)
+			{
+				batches.push_back(ChunksBatch{descriptor_set.materials_descriptor_set[texture], first_draw_command, draw_commands_count});
+			}
+		}
+
+		return batches;
+	}
+
+	void VulkanSceneRenderer::RenderChunks(const std::vector<ChunksBatch> &batches, uint32_t view_projection_offset)
+	{
+		if (batches.empty())
+		{
+			return;
+		}
+
+		auto &frame_config = *frame_config_;
+		auto &descriptor_set = descriptor_sets_[frame_config.image_index];
+
+		// The draws are read from the start of the frame buffer, so the instance indices skip the data placed before them
+		auto draws = frame_allocator_->Write(chunk_draws_.data(), chunk_draws_.size(), sizeof(ChunkDraw));
+		auto first_draw = static_cast<uint32_t>(draws.offset / sizeof(ChunkDraw));
+		for (auto &draw_command : chunk_draw_commands_)
+		{
+			draw_command.firstInstance += first_draw;
+		}
+		auto draw_commands = frame_allocator_->Write(chunk_draw_commands_.data(), chunk_draw_commands_.size(), sizeof(uint32_t));
+
+		auto command_buffer = frame_config.command_buffer;
+		chunk_indirect_pipeline_->Bind(command_buffer);
+
+		auto index_buffer = chunk_arena_.GetIndexBuffer();
+		WaitForUpload(chunk_arena_.GetVertexBufferUploadValue());
+		WaitForUpload(index_buffer->GetUploadValue());
+
+		VkBuffer vertex_buffers[] = {chunk_arena_.GetVertexBuffer()->GetBuffer()};
+		VkDeviceSize offsets[] = {0};
+		vkCmdBindVertexBuffers(command_buffer, 0, 1, vertex_buffers, offsets);
+		vkCmdBindIndexBuffer(command_buffer, index_buffer->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+
+		for (auto &batch : batches)
+		{
+			std::vector<VkDescriptorSet> descriptor_sets = {descriptor_set.chunk_draws_descriptor_set, batch.material_descriptor_set};
+			vkCmdBindDescriptorSets(command_buffer,
+									VK_PIPELINE_BIND_POINT_GRAPHICS,
+									chunk_indirect_pipeline_layout_,
+									0,
+									descriptor_sets.size(),
+									descriptor_sets.data(),
+									1,
+									&view_projection_offset);
+
+			if (device_.SupportsMultiDrawIndirect())
+			{
+				vkCmdDrawIndexedIndirect(command_buffer,
+										 frame_allocator_->GetBuffer(frame_config.image_index).GetBuffer(),
+										 draw_commands.offset + batch.first_draw_command * sizeof(VkDrawIndexedIndirectCommand),
+										 batch.draw_commands_count,
+										 sizeof(VkDrawIndexedIndirectCommand));
+				continue;
+			}
+
+			for (auto c = batch.first_draw_command; c < batch.first_draw_command + batch.draw_commands_count; ++c)
+			{
+				auto &draw_command = chunk_draw_commands_[c];
+				vkCmdDrawIndexed(command_buffer, draw_command.indexCount, draw_command.instanceCount, draw_command.firstIndex, draw_command.vertexOffset, draw_command.firstInstance);
+			}
+		}
+
+		auto arena_statistics = chunk_arena_.GetStatistics();
+		char buffer[96];
+		std::snprintf(buffer, sizeof(buffer), "%u chunks, %u commands, %u draw calls, arena %.1f/%.1f MB",
+					  static_cast<uint32_t>(chunk_draws_.size()),
+					  static_cast<uint32_t>(chunk_draw_commands_.size()),
+					  device_.SupportsMultiDrawIndirect() ? static_cast<uint32_t>(batches.size()) : static_cast<uint32_t>(chunk_draw_commands_.size()),
+					  arena_statistics.used_bytes / (1024.0 * 1024.0),
+					  arena_statistics.capacity_bytes / (1024.0 * 1024.0));
+		LOGVALUE("chunk draws", buffer);
+	}
+
+	void VulkanSceneRenderer::WaitForUpload(uint64_t upload_value)
+	{
+		frame_config_->upload_wait_value = std::max(frame_config_->upload_wait_value, upload_value);
+	}
+
+	void VulkanSceneRenderer::WaitForCompute(VkSemaphore compute_semaphore, uint64_t compute_value)
+	{
+		if (compute_value == 0)
+		{
+			return;
+		}
+
+		// A single mesher signals every computed chunk
+		frame_config_->compute_semaphore = compute_semaphore;
+		frame_config_->compute_wait_value = std::max(frame_config_->compute_wait_value, compute_value);
+	}
+
 	void VulkanSceneRenderer::CreatePipelineLayout()
 	{
 		std::vector<VkDescriptorSetLayout> descriptor_set_layouts = {mvp_descriptor_set_layout_->GetDescriptorSetLayout(), material_descriptor_set_layout_->GetDescriptorSetLayout()};
@@ -221,6 +465,15 @@ namespace plaincraft_render_engine_vulkan
 		{
 			throw std::runtime_error("Failed to create pipeline layout");
 		}
+
+		std::vector<VkDescriptorSetLayout> chunk_indirect_descriptor_set_layouts = {chunk_draws_descriptor_set_layout_->GetDescriptorSetLayout(), material_descriptor_set_layout_->GetDescriptorSetLayout()};
+		pipeline_layout_create_info.setLayoutCount = chunk_indirect_descriptor_set_layouts.size();
+		pipeline_layout_create_info.pSetLayouts = chunk_indirect_descriptor_set_layouts.data();
+
+		if (vkCreatePipelineLayout(device_.GetDevice(), &pipeline_layout_create_info, nullptr, &chunk_indirect_pipeline_layout_) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Failed to create chunk indirect pipeline layout");
+		}
 	}
 
 	void VulkanSceneRenderer::SetupPipelineConfig(VulkanPipelineConfig &pipeline_config, VkViewport &viewport, VkRect2D &scissor)
@@ -244,89 +497,28 @@ namespace plaincraft_render_engine_vulkan
 		pipeline_config.viewport_info.pScissors = &scissor;
 	}
 
-	void VulkanSceneRenderer::RecreateEntitiesBuffers()
-	{
-		CreateUniformBuffers();
-		CreateBasicDescriptors();
-	}
-
-	void VulkanSceneRenderer::CreateUniformBuffers()
-	{
-		VkPhysicalDeviceProperties physical_device_properties;
-		vkGetPhysicalDeviceProperties(device_.GetPhysicalDevice(), &physical_device_properties);
-		auto min_ubo_alignment = physical_device_properties.limits.minUniformBufferOffsetAlignment;
-
-		view_projection_buffers_.resize(images_count_);
-		model_buffers_.resize(images_count_);
-
-		auto next_power_of_2 = [](uint32_t number) -> uint32_t
-		{
-			uint32_t count = 0;
-
-			if (number && !(number & (number - 1)))
-			{
-				return number;
-			}
-
-			while (number != 0)
-			{
-				number >>= 1;
-				count += 1;
-			}
-
-			return 1 << count;
-		};
-
-		auto entities_count = static_cast<uint32_t>(drawables_list_.size());
-		if (entities_count == 0)
-		{
-			entities_count = 1;
-		}
-
-		buffers_instance_count_ = next_power_of_2(entities_count);
-
-		for (size_t i = 0; i < images_count_; ++i)
-		{
-			view_projection_buffers_[i] = std::make_unique<VulkanBuffer>(device_,
-																		 sizeof(ViewProjectionMatrix),
-																		 1,
-																		 VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-																		 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-																		 min_ubo_alignment);
-
-			model_buffers_[i] = std::make_unique<VulkanBuffer>(device_,
-															   sizeof(ModelMatrix),
-															   buffers_instance_count_,
-															   VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-															   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-															   min_ubo_alignment);
-		}
-
-		if (model_memory_ != nullptr)
-		{
-			_aligned_free(model_memory_);
-		}
-		model_memory_ = static_cast<ModelMatrix *>(_aligned_malloc(model_buffers_[0]->GetAlignmentSize() * buffers_instance_count_, model_buffers_[0]->GetAlignmentSize()));
-	}
-
 	void VulkanSceneRenderer::CreateDescriptorSetLayout()
 	{
 		mvp_descriptor_set_layout_ = VulkanDescriptorSetLayout::Builder(device_)
 										 .AddLayoutBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, VK_SHADER_STAGE_VERTEX_BIT, 1)
-										 .AddLayoutBinding(1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT, 1)
+										 .AddLayoutBinding(1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, VK_SHADER_STAGE_VERTEX_BIT, 1)
 										 .Build();
 		material_descriptor_set_layout_ = VulkanDescriptorSetLayout::Builder(device_)
 											  .AddLayoutBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, 1)
 											  .Build();
+		chunk_draws_descriptor_set_layout_ = VulkanDescriptorSetLayout::Builder(device_)
+												 .AddLayoutBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, VK_SHADER_STAGE_VERTEX_BIT, 1)
+												 .AddLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT, 1)
+												 .Build();
 	}
 
 	void VulkanSceneRenderer::CreateDescriptorPool()
 	{
 		descriptor_pool_ = VulkanDescriptorPool::Builder(device_)
 							   .SetMaxSets(images_count_ * default_frame_pool_size_)
-							   .AddPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1)
-							   .AddPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1)
+							   .AddPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, images_count_ * 3)
 							   .AddPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1)
+							   .AddPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, images_count_)
 							   .SetPoolFlags(VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT)
 							   .Build();
 		descriptor_sets_.resize(images_count_);
@@ -347,30 +539,42 @@ namespace plaincraft_render_engine_vulkan
 		return result;
 	}
 
-	void VulkanSceneRenderer::CreateBasicDescriptors()
+	void VulkanSceneRenderer::CreateFrameDescriptors(uint32_t image_index)
 	{
-		for (size_t i = 0; i < descriptor_sets_.size(); ++i)
+		auto &frame_descriptor_sets = descriptor_sets_[image_index];
+		auto frame_buffer = frame_allocator_->GetBuffer(image_index).GetBuffer();
+
+		VkDescriptorBufferInfo model_buffer_descriptor_info{};
+		model_buffer_descriptor_info.buffer = frame_buffer;
+		model_buffer_descriptor_info.offset = 0;
+		model_buffer_descriptor_info.range = sizeof(ModelMatrix);
+
+		VkDescriptorBufferInfo view_projection_buffer_descriptor_info{};
+		view_projection_buffer_descriptor_info.buffer = frame_buffer;
+		view_projection_buffer_descriptor_info.offset = 0;
+		view_projection_buffer_descriptor_info.range = sizeof(ViewProjectionMatrix);
+
+		VkDescriptorBufferInfo draws_buffer_descriptor_info{};
+		draws_buffer_descriptor_info.buffer = frame_buffer;
+		draws_buffer_descriptor_info.offset = 0;
+		draws_buffer_descriptor_info.range = VK_WHOLE_SIZE;
+
+		std::vector<VkDescriptorSet> old_descriptor_sets;
+		if (frame_descriptor_sets.mvp_descriptor_set != VK_NULL_HANDLE)
 		{
-			VkDescriptorBufferInfo model_buffer_descriptor_info{};
-			model_buffer_descriptor_info.buffer = model_buffers_[i]->GetBuffer();
-			model_buffer_descriptor_info.offset = 0;
-			model_buffer_descriptor_info.range = sizeof(ModelMatrix);
-
-			VkDescriptorBufferInfo view_projection_buffer_descriptor_info{};
-			view_projection_buffer_descriptor_info.buffer = view_projection_buffers_[i]->GetBuffer();
-			view_projection_buffer_descriptor_info.offset = 0;
-			view_projection_buffer_descriptor_info.range = sizeof(ViewProjectionMatrix);
+			old_descriptor_sets.push_back(frame_descriptor_sets.mvp_descriptor_set);
+			old_descriptor_sets.push_back(frame_descriptor_sets.chunk_draws_descriptor_set);
+			descriptor_pool_->FreeDescriptors(old_descriptor_sets);
+		}
 
-			if (descriptor_sets_[i].mvp_descriptor_set != VK_NULL_HANDLE)
-			{
-				std::vector<VkDescriptorSet> old_descriptor_sets = {descriptor_sets_[i].mvp_descriptor_set};
-				descriptor_pool_->FreeDescriptors(old_descriptor_sets);
-			}
+		VulkanDescriptorWriter mvp_descriptor_writer(*mvp_descriptor_set_layout_, *descriptor_pool_);
+		mvp_descriptor_writer.WriteBuffer(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, &model_buffer_descriptor_info);
+		mvp_descriptor_writer.WriteBuffer(1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, &view_projection_buffer_descriptor_info);
+		mvp_descriptor_writer.Build(frame_descriptor_sets.mvp_descriptor_set);
 
-			VulkanDescriptorWriter descriptor_writer(*mvp_descriptor_set_layout_, *descriptor_pool_);
-			descriptor_writer.WriteBuffer(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, &model_buffer_descriptor_info);
-			descriptor_writer.WriteBuffer(1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, &view_projection_buffer_descriptor_info);
-			descriptor_writer.Build(descriptor_sets_[i].mvp_descriptor_set);
-		}
+		VulkanDescriptorWriter chunk_draws_descriptor_writer(*chunk_draws_descriptor_set_layout_, *descriptor_pool_);
+		chunk_draws_descriptor_writer.WriteBuffer(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, &view_projection_buffer_descriptor_info);
+		chunk_draws_descriptor_writer.WriteBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &draws_buffer_descriptor_info);
+		chunk_draws_descriptor_writer.Build(frame_descriptor_sets.chunk_draws_descriptor_set);
 	}
 }
\ No newline at end of file
@@ -31,7 +31,11 @@ SOFTWARE.
 #include "../swapchain/vulkan_swapchain.hpp"
 #include "../pipeline/vulkan_pipeline.hpp"
 #include "../memory/vulkan_buffer.hpp"
+#include "../memory/vulkan_frame_allocator.hpp"
 #include "../models/vulkan_model.hpp"
+#include "../models/vulkan_chunk_model.hpp"
+#include "../models/vulkan_chunk_arena.hpp"
+#include "../models/vulkan_computed_chunk_model.hpp"
 #include "../vulkan_renderer_frame_config.hpp"
 #include "../descriptors/vulkan_descriptor_set_layout.hpp"
 #include "../descriptors/vulkan_descriptor_pool.hpp"
@@ -50,32 +54,51 @@ namespace plaincraft_render_engine_vulkan {
         glm::mat4 transform;
     };
 
+    // Per chunk data of the indirect chunk draws, indexed by the instance index of each command
+    struct ChunkDraw
+    {
+        glm::vec4 position;
+        glm::vec4 color;
+    };
+
     class VulkanSceneRenderer : public SceneRenderer {
     private:
         VulkanDevice& device_;
+        VulkanChunkArena& chunk_arena_;
         VkRenderPass render_pass_;
         VkExtent2D extent_;
         size_t images_count_;
         
         std::unique_ptr<VulkanPipeline> pipeline_;
+        std::unique_ptr<VulkanPipeline> chunk_pipeline_;
+        std::unique_ptr<VulkanPipeline> chunk_indirect_pipeline_;
 		VkPipelineLayout pipeline_layout_;
+        VkPipelineLayout chunk_indirect_pipeline_layout_;
 
         static constexpr uint32_t default_frame_pool_size_ = 256;
 		
+        // Uniform and storage descriptors point at the frame allocator buffer of the image, dynamic offsets pick the data
         struct FrameDescriptorSets {
-            VkDescriptorSet mvp_descriptor_set;
+            VkDescriptorSet mvp_descriptor_set = VK_NULL_HANDLE;
+            VkDescriptorSet chunk_draws_descriptor_set = VK_NULL_HANDLE;
             std::unordered_map<std::shared_ptr<Texture>, VkDescriptorSet> materials_descriptor_set;
         };
         std::unique_ptr<VulkanDescriptorPool> descriptor_pool_;
 		std::unique_ptr<VulkanDescriptorSetLayout> mvp_descriptor_set_layout_;
         std::unique_ptr<VulkanDescriptorSetLayout> material_descriptor_set_layout_;
+        std::unique_ptr<VulkanDescriptorSetLayout> chunk_draws_descriptor_set_layout_;
         std::vector<FrameDescriptorSets> descriptor_sets_;
 
-        std::vector<std::unique_ptr<VulkanBuffer>> model_buffers_;
-        uint32_t buffers_instance_count_;
-        ModelMatrix* model_memory_ = nullptr;
+        struct ChunksBatch {
+            VkDescriptorSet material_descriptor_set;
+            uint32_t first_draw_command;
+            uint32_t draw_commands_count;
+        };
+        std::vector<ChunkDraw> chunk_draws_;
+        std::vector<VkDrawIndexedIndirectCommand> chunk_draw_commands_;
 
-        std::vector<std::unique_ptr<VulkanBuffer>> view_projection_buffers_;
+        std::unique_ptr<VulkanFrameAllocator> frame_allocator_;
+        VkDeviceSize min_uniform_buffer_alignment_;
 
         std::vector<std::unique_ptr<VulkanImage>> texture_images_;
         std::vector<std::unique_ptr<VulkanImageView>> texture_images_views_;
@@ -83,8 +106,13 @@ namespace plaincraft_render_engine_vulkan {
 
         VulkanRendererFrameConfig* frame_config_ {nullptr};
 
+        FrustumCullingKernel::BoundingBoxes culling_boxes_;
+        std::vector<uint32_t> culling_boxes_drawables_;
+        std::vector<uint8_t> culling_boxes_visibility_;
+        std::vector<uint8_t> drawables_visibility_;
+
     public:
-        VulkanSceneRenderer(VulkanDevice& device, VkRenderPass render_pass, VkExtent2D extent, size_t images_count, std::shared_ptr<Camera> camera);
+        VulkanSceneRenderer(VulkanDevice& device, VulkanChunkArena& chunk_arena, VkRenderPass render_pass, VkExtent2D extent, size_t images_count, std::shared_ptr<Camera> camera);
         ~VulkanSceneRenderer() override;
 
         void BeginFrame(VulkanRendererFrameConfig& frame_config);
@@ -99,17 +127,23 @@ namespace plaincraft_render_engine_vulkan {
 		void SetupPipelineConfig(VulkanPipelineConfig& pipeline_config, VkViewport& viewport, VkRect2D& scissor);
 		void CreatePipelineLayout();
         
-		void CreateUniformBuffers();
         void CreateImages();
         void CreateImagesViews();
 
         void CreateDescriptorSetLayout();
         void CreateDescriptorPool();
-        void CreateBasicDescriptors();
+        void CreateFrameDescriptors(uint32_t image_index);
         
         VkDescriptorSet CreateMaterialDescriptorSet(VkImageView texture_image_view, VkSampler texture_sampler);
 
-        void RecreateEntitiesBuffers();
+        void CullDrawables(const glm::mat4& view_projection);
+
+        using DrawablesGroups = std::unordered_map<std::shared_ptr<Texture>, std::vector<std::reference_wrapper<Drawable>>>;
+        std::vector<ChunksBatch> CollectChunkDraws(const DrawablesGroups& chunks_grouped);
+        void RenderChunks(const std::vector<ChunksBatch>& batches, uint32_t view_projection_offset);
+
+        void WaitForUpload(uint64_t upload_value);
+        void WaitForCompute(VkSemaphore compute_semaphore, uint64_t compute_value);
     };
 }
 
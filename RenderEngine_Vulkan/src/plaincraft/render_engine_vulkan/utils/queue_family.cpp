@@ -42,20 +42,37 @@ namespace plaincraft_render_engine_vulkan
 		int i = 0;
 		for (const auto &queue_family : queue_families)
 		{
-			if (queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+			if (!indices.IsComplete())
 			{
-				indices.graphics_family = i;
-			}
+				if (queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+				{
+					indices.graphics_family = i;
+				}
+
+				// Nothing is presented without a surface, the graphics family stands in for the present one
+				if (surface == VK_NULL_HANDLE)
+				{
+					indices.present_family = indices.graphics_family;
+				}
+				else
+				{
+					VkBool32 present_support = false;
+					vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &present_support);
 
-			VkBool32 present_support = false;
-			vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &present_support);
+					if (present_support)
+					{
+						indices.present_family = i;
+					}
+				}
+			}
 
-			if (present_support)
+			auto is_transfer_only = (queue_family.queueFlags & VK_QUEUE_TRANSFER_BIT) && !(queue_family.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT));
+			if (!indices.transfer_family.has_value() && is_transfer_only)
 			{
-				indices.present_family = i;
+				indices.transfer_family = i;
 			}
 
-			if (indices.IsComplete())
+			if (indices.IsComplete() && indices.transfer_family.has_value())
 			{
 				break;
 			}
@@ -35,6 +35,8 @@ namespace plaincraft_render_engine_vulkan
     struct QueueFamilyIndices {
 		std::optional<uint32_t> graphics_family;
 		std::optional<uint32_t> present_family;
+		// Family with copy engines only, uploads on it run alongside rendering
+		std::optional<uint32_t> transfer_family;
 
 		bool IsComplete() {
 			return graphics_family.has_value() && present_family.has_value();
@@ -38,6 +38,7 @@ SOFTWARE.
 #include "gui/font/vulkan_fonts_factory.hpp"
 #include "gui/menu/vulkan_menu_factory.hpp"
 #include "models/vulkan_models_factory.hpp"
+#include "memory/vulkan_upload_manager.hpp"
 #include <stdexcept>
 #include <iostream>
 #include <glm/gtx/quaternion.hpp>
@@ -53,10 +54,13 @@ namespace plaincraft_render_engine_vulkan
 		  surface_(GetVulkanWindow()->CreateSurface(instance_.GetInstance())),
 		  device_(VulkanDevice(instance_, surface_))
 	{
+		chunk_arena_ = std::make_shared<VulkanChunkArena>(device_);
+
 		RecreateSwapChain();
 		CreateSyncObjects();
+		CreateAcquireCommandBuffers();
 
-		models_factory_ = std::make_unique<VulkanModelsFactory>(VulkanModelsFactory(device_));
+		models_factory_ = std::make_unique<VulkanModelsFactory>(device_, *chunk_arena_);
 		textures_factory_ = std::make_unique<VulkanTexturesFactory>(device_);
 		menu_factory_ = std::make_unique<VulkanMenuFactory>();
 		fonts_factory_ = std::make_unique<VulkanFontsFactory>(device_);
@@ -68,6 +72,8 @@ namespace plaincraft_render_engine_vulkan
 		std::lock_guard guard(drawables_list_mutex_);
 		drawables_list_.clear();
 
+		device_.GetUploadManager().WaitIdle(); // uploads may still write into the buffers released below
+
 		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			vkDestroySemaphore(device_.GetDevice(), render_finished_semaphores_[i], nullptr);
@@ -88,6 +94,8 @@ namespace plaincraft_render_engine_vulkan
 		vkDestroySurfaceKHR(instance_.GetInstance(), surface_, nullptr);
 
 		scene_renderer_.reset(); // because it relies on device which would be deleted before renderer
+		models_factory_.reset(); // the same goes for the buffers and the compute pipeline it owns
+		chunk_arena_.reset(); // chunk models still alive afterwards no longer return their ranges
 	}
 
 	void VulkanRenderEngine::CreateCommandBuffers()
@@ -106,6 +114,22 @@ namespace plaincraft_render_engine_vulkan
 		}
 	}
 
+	void VulkanRenderEngine::CreateAcquireCommandBuffers()
+	{
+		acquire_command_buffers_.resize(MAX_FRAMES_IN_FLIGHT);
+
+		VkCommandBufferAllocateInfo allocate_info{};
+		allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocate_info.commandPool = device_.GetGraphicsCommandPool();
+		allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocate_info.commandBufferCount = static_cast<uint32_t>(acquire_command_buffers_.size());
+
+		if (vkAllocateCommandBuffers(device_.GetDevice(), &allocate_info, acquire_command_buffers_.data()) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Failed to allocate acquire command buffers");
+		}
+	}
+
 	void VulkanRenderEngine::CreateSyncObjects()
 	{
 		image_available_semaphores_.resize(MAX_FRAMES_IN_FLIGHT);
@@ -150,7 +174,7 @@ namespace plaincraft_render_engine_vulkan
 			swapchain_ = std::make_unique<Swapchain>(GetVulkanWindow(), device_, surface_, std::move(swapchain_));
 		}
 
-		scene_renderer_ = std::make_unique<VulkanSceneRenderer>(device_, swapchain_->GetRenderPass(), swapchain_->GetSwapchainExtent(), swapchain_->GetSwapchainImages().size(), camera_);
+		scene_renderer_ = std::make_unique<VulkanSceneRenderer>(device_, *chunk_arena_, swapchain_->GetRenderPass(), swapchain_->GetSwapchainExtent(), swapchain_->GetSwapchainImages().size(), camera_);
 
 		if (gui_renderer_ == nullptr)
 		{
@@ -272,16 +296,52 @@ namespace plaincraft_render_engine_vulkan
 			throw std::runtime_error("Failed to record command buffer");
 		}
 
+		// Uploads recorded while the frame was built go out first, the frame waits only for what it draws
+		auto &upload_manager = device_.GetUploadManager();
+		upload_manager.Submit();
+
+		auto upload_wait_value = vulkan_renderer_frame_config.upload_wait_value;
+		auto acquire_command_buffer = acquire_command_buffers_[current_frame_];
+		std::vector<VkCommandBuffer> submit_command_buffers;
+		if (upload_manager.RecordAcquireBarriers(acquire_command_buffer, upload_wait_value))
+		{
+			submit_command_buffers.push_back(acquire_command_buffer);
+		}
+		submit_command_buffers.push_back(command_buffer);
+
+		std::vector<VkSemaphore> wait_semaphores = {image_available_semaphores_[current_frame_]};
+		std::vector<VkPipelineStageFlags> wait_stages = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+		std::vector<uint64_t> wait_values = {0};
+		if (upload_wait_value > 0)
+		{
+			wait_semaphores.push_back(upload_manager.GetTimelineSemaphore());
+			wait_stages.push_back(VulkanUploadManager::consumer_stages);
+			wait_values.push_back(upload_wait_value);
+		}
+
+		// Computed chunks read their draw command and vertices written by the mesher dispatches
+		auto compute_wait_value = vulkan_renderer_frame_config.compute_wait_value;
+		if (compute_wait_value > 0)
+		{
+			wait_semaphores.push_back(vulkan_renderer_frame_config.compute_semaphore);
+			wait_stages.push_back(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+			wait_values.push_back(compute_wait_value);
+		}
+
+		VkTimelineSemaphoreSubmitInfo timeline_submit_info{};
+		timeline_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timeline_submit_info.waitSemaphoreValueCount = static_cast<uint32_t>(wait_values.size());
+		timeline_submit_info.pWaitSemaphoreValues = wait_values.data();
+
 		VkSubmitInfo submit_info{};
 		submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submit_info.pNext = &timeline_submit_info;
 
-		VkSemaphore wait_semaphores[] = {image_available_semaphores_[current_frame_]};
-		VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-		submit_info.waitSemaphoreCount = 1;
-		submit_info.pWaitSemaphores = wait_semaphores;
-		submit_info.pWaitDstStageMask = wait_stages;
-		submit_info.commandBufferCount = 1;
-		submit_info.pCommandBuffers = &command_buffer;
+		submit_info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size());
+		submit_info.pWaitSemaphores = wait_semaphores.data();
+		submit_info.pWaitDstStageMask = wait_stages.data();
+		submit_info.commandBufferCount = static_cast<uint32_t>(submit_command_buffers.size());
+		submit_info.pCommandBuffers = submit_command_buffers.data();
 
 		VkSemaphore signal_semaphores[] = {render_finished_semaphores_[current_frame_]};
 		submit_info.signalSemaphoreCount = 1;
@@ -38,6 +38,7 @@ SOFTWARE.
 #include "memory/vulkan_texture.hpp"
 #include "memory/vulkan_image.hpp"
 #include "models/vulkan_model.hpp"
+#include "models/vulkan_chunk_arena.hpp"
 #include "scene/vulkan_scene_renderer.hpp"
 #include "gui/vulkan_gui_renderer.hpp"
 #include <plaincraft_render_engine.hpp>
@@ -58,6 +59,9 @@ namespace plaincraft_render_engine_vulkan {
 
 		std::vector<VkCommandBuffer> command_buffers_;
 
+		// Per frame in flight, acquires the resources released by the upload queue before the frame uses them
+		std::vector<VkCommandBuffer> acquire_command_buffers_;
+
 		std::vector<VkSemaphore> image_available_semaphores_;
 		std::vector<VkSemaphore> render_finished_semaphores_;
 		std::vector<VkFence> in_flight_fences_;
@@ -66,6 +70,8 @@ namespace plaincraft_render_engine_vulkan {
 		
 		std::unique_ptr<VulkanGuiRenderer> gui_renderer_;
 
+		std::shared_ptr<VulkanChunkArena> chunk_arena_;
+
 		bool enable_debug_;
 
 	public:
@@ -93,6 +99,7 @@ namespace plaincraft_render_engine_vulkan {
 		uint32_t FindMemoryType(uint32_t type_filter, VkMemoryPropertyFlags memory_properties);
 		
 		void CreateSyncObjects();
+		void CreateAcquireCommandBuffers();
 
 		void CreateUniformBuffers();
 
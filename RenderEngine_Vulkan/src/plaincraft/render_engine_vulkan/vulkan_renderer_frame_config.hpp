@@ -37,6 +37,11 @@ namespace plaincraft_render_engine_vulkan {
         const FrameConfig& frame_config; 
         VkCommandBuffer& command_buffer;
         size_t image_index;
+        // Highest upload manager value among the resources the frame draws
+        uint64_t upload_wait_value = 0;
+        // Chunk compute mesher semaphore and the highest value among the chunks the frame draws
+        VkSemaphore compute_semaphore = VK_NULL_HANDLE;
+        uint64_t compute_wait_value = 0;
     };
 };
 
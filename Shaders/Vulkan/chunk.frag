@@ -0,0 +1,20 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) out vec4 outColor;
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragTextCoord;
+layout(location = 2) flat in vec2 fragTile;
+
+layout(set = 1, binding = 0) uniform sampler2D texSampler;
+
+const float TILE_SIZE = 16.0;
+
+void main() {
+    // Texture coordinates are counted in blocks, so merged faces repeat the tile instead of stretching it
+    vec2 tileScale = TILE_SIZE / vec2(textureSize(texSampler, 0));
+    vec2 uv = (fragTile + fract(fragTextCoord)) * tileScale;
+
+    outColor = vec4(fragColor, 1.0) * textureGrad(texSampler, uv, dFdx(fragTextCoord * tileScale), dFdy(fragTextCoord * tileScale));
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Packed as described by plaincraft_render_engine::ChunkVertex
+layout(location = 0) in uint inPositionNormalUv;
+layout(location = 1) in uint inTile;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTextCoord;
+layout(location = 2) flat out vec2 fragTile;
+
+layout(set = 0, binding = 0) uniform ViewProjectionMatrix {
+    mat4 view;
+    mat4 projection;
+} view_projection_matrix;
+
+// Packed as described by plaincraft_render_engine_vulkan::ChunkDraw, the instance index selects the chunk
+struct ChunkDraw {
+    vec4 position;
+    vec4 color;
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer ChunkDraws {
+    ChunkDraw draws[];
+} chunk_draws;
+
+const vec3 DIRECTION_TO_LIGHT = normalize(vec3(1.0, 3.0, -1.0));
+const float AMBIENT = 0.05;
+
+const vec3 NORMALS[6] = vec3[](
+    vec3(0.0, 1.0, 0.0),
+    vec3(0.0, -1.0, 0.0),
+    vec3(-1.0, 0.0, 0.0),
+    vec3(1.0, 0.0, 0.0),
+    vec3(0.0, 0.0, -1.0),
+    vec3(0.0, 0.0, 1.0));
+
+void main() {
+    vec3 inPosition = vec3(inPositionNormalUv & 31u, (inPositionNormalUv >> 5) & 127u, (inPositionNormalUv >> 12) & 31u) - 0.5;
+    vec3 normal = NORMALS[(inPositionNormalUv >> 17) & 7u];
+    vec2 textMapping = vec2((inPositionNormalUv >> 20) & 31u, (inPositionNormalUv >> 25) & 31u);
+
+    ChunkDraw draw = chunk_draws.draws[gl_InstanceIndex];
+
+    // Chunks are only translated, so the normal is already in world space
+    gl_Position = view_projection_matrix.projection * view_projection_matrix.view * vec4(draw.position.xyz + inPosition, 1.0);
+
+    float lightIntensity = max(dot(normal, DIRECTION_TO_LIGHT), 0);
+    lightIntensity = max(lightIntensity, AMBIENT);
+
+    fragColor = draw.color.rgb * lightIntensity;
+    fragTextCoord = textMapping;
+    fragTile = vec2(inTile & 255u, (inTile >> 8) & 255u);
+}
\ No newline at end of file
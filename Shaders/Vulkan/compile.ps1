@@ -1,2 +1,6 @@
 C:\VulkanSDK\1.2.162.0\Bin\glslc.exe shader.vert -o vert.spv
-C:\VulkanSDK\1.2.162.0\Bin\glslc.exe shader.frag -o frag.spv
\ No newline at end of file
+C:\VulkanSDK\1.2.162.0\Bin\glslc.exe shader.frag -o frag.spv
+C:\VulkanSDK\1.2.162.0\Bin\glslc.exe chunk.vert -o chunk_vert.spv
+C:\VulkanSDK\1.2.162.0\Bin\glslc.exe chunk.frag -o chunk_frag.spv
+C:\VulkanSDK\1.2.162.0\Bin\glslc.exe chunk_indirect.vert -o chunk_indirect_vert.spv
+C:\VulkanSDK\1.2.162.0\Bin\glslc.exe chunk_mesh.comp -o chunk_mesh_comp.spv
\ No newline at end of file
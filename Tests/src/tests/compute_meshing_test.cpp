@@ -0,0 +1,342 @@
+/*
+MIT License
+
+This file is part of Plaincraft (https://github.com/unimator/Plaincraft)
+
+Copyright (c) 2020 Marcin Gorka
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <plaincraft_core.hpp>
+#include <plaincraft/render_engine_vulkan/device/vulkan_device.hpp>
+#include <plaincraft/render_engine_vulkan/instance/vulkan_instance.hpp>
+#include <plaincraft/render_engine_vulkan/memory/vulkan_buffer.hpp>
+#include <plaincraft/render_engine_vulkan/models/vulkan_chunk_compute_mesher.hpp>
+#include <plaincraft/render_engine_vulkan/models/vulkan_quad_index_buffer.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace plaincraft_core;
+using namespace plaincraft_render_engine_vulkan;
+
+// Meshes fixed chunk corpora with the naive CPU mesher and with the chunk mesh compute shader on a headless
+// device, then compares the quads of both. Exits with 1 on a mismatch and with 77 when there is no device to run on.
+// Usage: ComputeMeshingTest [--shader path]
+
+namespace
+{
+	constexpr int32_t corpus_size = 3;
+	constexpr uint64_t corpus_seed = 1337;
+	constexpr int skipped_exit_code = 77;
+
+	// Chunks of a corpus_size x corpus_size grid, chunks[z * corpus_size + x]
+	struct Corpus
+	{
+		const char *name;
+		std::vector<std::shared_ptr<Chunk>> chunks;
+	};
+
+	// Vertices of one quad packed as tile << 32 | position_normal_uv
+	using Quad = std::array<uint64_t, ChunkMesh::vertices_per_quad>;
+
+	using BlockGenerator = std::function<BlockId(int32_t x, uint32_t y, int32_t z)>;
+	using ChunkGenerator = std::function<void(const std::shared_ptr<Chunk> &chunk)>;
+
+	Corpus CreateCorpus(const char *name, const ChunkGenerator &generator)
+	{
+		Corpus corpus{name, {}};
+		for (int32_t chunk_z = 0; chunk_z < corpus_size; ++chunk_z)
+		{
+			for (int32_t chunk_x = 0; chunk_x < corpus_size; ++chunk_x)
+			{
+				auto chunk = std::make_shared<Chunk>(chunk_x, chunk_z);
+				generator(chunk);
+				chunk->initialized_ = true;
+				corpus.chunks.push_back(chunk);
+			}
+		}
+		return corpus;
+	}
+
+	ChunkGenerator FillBlocks(const BlockGenerator &generator)
+	{
+		return [generator](const std::shared_ptr<Chunk> &chunk)
+		{
+			auto origin_x = chunk->GetPositionX() * static_cast<int32_t>(Chunk::chunk_size);
+			auto origin_z = chunk->GetPositionZ() * static_cast<int32_t>(Chunk::chunk_size);
+			for (uint32_t y = 0; y < Chunk::chunk_height; ++y)
+			{
+				for (uint32_t z = 0; z < Chunk::chunk_size; ++z)
+				{
+					for (uint32_t x = 0; x < Chunk::chunk_size; ++x)
+					{
+						auto block_id = generator(origin_x + static_cast<int32_t>(x), y, origin_z + static_cast<int32_t>(z));
+						if (block_id != BlockIds::air)
+						{
+							chunk->SetBlock(x, y, z, block_id);
+						}
+					}
+				}
+			}
+		};
+	}
+
+	std::vector<Corpus> CreateCorpora()
+	{
+		std::vector<Corpus> corpora;
+
+		ChunkBuilder chunk_builder(nullptr, corpus_seed);
+		corpora.push_back(CreateCorpus("perlin", [&chunk_builder](const std::shared_ptr<Chunk> &chunk)
+									   { chunk_builder.GenerateChunk(chunk, CancellationToken()); }));
+
+		// Every block is exposed on all six faces, including the faces on the chunk borders
+		corpora.push_back(CreateCorpus("checkerboard", FillBlocks([](int32_t x, uint32_t y, int32_t z)
+																  { return ((x + static_cast<int32_t>(y) + z) & 1) == 0 ? BlockIds::stone : BlockIds::air; })));
+
+		// Blocks with different tiles per face mixed at random, so a face taking the tile of another one shows up
+		corpora.push_back(CreateCorpus("scattered", FillBlocks([](int32_t x, uint32_t y, int32_t z)
+															   {
+																   auto hash = (static_cast<uint32_t>(x) * 73856093u) ^ (y * 19349663u) ^ (static_cast<uint32_t>(z) * 83492791u);
+																   hash = (hash ^ (hash >> 13)) * 0x5bd1e995u;
+																   switch ((hash >> 16) % 3)
+																   {
+																   case 0:
+																	   return BlockIds::stone;
+																   case 1:
+																	   return BlockIds::dirt;
+																   default:
+																	   return BlockIds::air;
+																   }
+															   })));
+
+		return corpora;
+	}
+
+	ChunkNeighbors GetNeighbors(const Corpus &corpus, int32_t chunk_x, int32_t chunk_z)
+	{
+		auto get_neighbor = [&corpus](int32_t x, int32_t z) -> std::shared_ptr<Chunk>
+		{
+			if (x < 0 || x >= corpus_size || z < 0 || z >= corpus_size)
+			{
+				return nullptr;
+			}
+			return corpus.chunks[z * corpus_size + x];
+		};
+
+		return ChunkNeighbors{get_neighbor(chunk_x - 1, chunk_z), get_neighbor(chunk_x + 1, chunk_z), get_neighbor(chunk_x, chunk_z - 1), get_neighbor(chunk_x, chunk_z + 1)};
+	}
+
+	std::vector<ChunkVertex> ReadVertices(const VulkanDevice &device, VulkanBuffer &vertex_buffer)
+	{
+		VulkanBuffer readback_buffer(device,
+									 sizeof(ChunkVertex),
+									 vertex_buffer.GetInstanceCount(),
+									 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+									 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+		auto command_pool = device.GetTransferCommandPool();
+		auto command_buffer = device.BeginSingleTimeCommands(command_pool);
+
+		VkMemoryBarrier shader_write_barrier{};
+		shader_write_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		shader_write_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		shader_write_barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &shader_write_barrier, 0, nullptr, 0, nullptr);
+
+		VkBufferCopy copy_region{};
+		copy_region.size = readback_buffer.GetBufferSize();
+		vkCmdCopyBuffer(command_buffer, vertex_buffer.GetBuffer(), readback_buffer.GetBuffer(), 1, &copy_region);
+
+		VkMemoryBarrier transfer_write_barrier{};
+		transfer_write_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		transfer_write_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		transfer_write_barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &transfer_write_barrier, 0, nullptr, 0, nullptr);
+
+		device.EndSingleTimeCommands(command_pool, command_buffer, device.GetTransferQueue());
+
+		std::vector<ChunkVertex> vertices(vertex_buffer.GetInstanceCount());
+		readback_buffer.Map(VK_WHOLE_SIZE, 0);
+		std::memcpy(vertices.data(), readback_buffer.GetMappedData(), vertices.size() * sizeof(ChunkVertex));
+		readback_buffer.Unmap();
+		return vertices;
+	}
+
+	// Both meshers may emit the quads in any order and start a quad at any corner, the winding is kept
+	std::vector<Quad> GetSortedQuads(const std::vector<ChunkVertex> &vertices)
+	{
+		std::vector<Quad> quads(vertices.size() / ChunkMesh::vertices_per_quad);
+		for (size_t i = 0; i < quads.size(); ++i)
+		{
+			auto &quad = quads[i];
+			for (uint32_t corner = 0; corner < ChunkMesh::vertices_per_quad; ++corner)
+			{
+				auto &vertex = vertices[i * ChunkMesh::vertices_per_quad + corner];
+				quad[corner] = static_cast<uint64_t>(vertex.tile) << 32 | vertex.position_normal_uv;
+			}
+			std::rotate(quad.begin(), std::min_element(quad.begin(), quad.end()), quad.end());
+		}
+
+		std::sort(quads.begin(), quads.end());
+		return quads;
+	}
+
+	std::vector<ChunkVertex> GetMeshVertices(const ChunkMesh &mesh)
+	{
+		std::vector<ChunkVertex> vertices;
+		for (uint32_t section_index = 0; section_index < mesh.GetSectionsCount(); ++section_index)
+		{
+			auto &section_vertices = mesh.GetSectionVertices(section_index);
+			vertices.insert(vertices.end(), section_vertices.begin(), section_vertices.end());
+		}
+		return vertices;
+	}
+
+	void PrintQuad(const char *label, const Quad &quad)
+	{
+		std::cerr << "  " << label << ":";
+		for (auto vertex : quad)
+		{
+			std::cerr << " " << std::hex << vertex << std::dec;
+		}
+		std::cerr << std::endl;
+	}
+
+	bool CompareChunk(const Corpus &corpus, int32_t chunk_x, int32_t chunk_z, ChunkMesher &cpu_mesher, ChunkMesher &voxels_packer, VulkanChunkComputeMesher &compute_mesher, const VulkanDevice &device)
+	{
+		auto &chunk = *corpus.chunks[chunk_z * corpus_size + chunk_x];
+		auto neighbors = GetNeighbors(corpus, chunk_x, chunk_z);
+
+		auto cpu_mesh = cpu_mesher.MeshChunk(chunk, neighbors);
+		auto cpu_quads = GetSortedQuads(GetMeshVertices(*cpu_mesh));
+
+		auto voxels_mesh = voxels_packer.MeshChunk(chunk, neighbors);
+		auto computed_model = compute_mesher.Mesh(*voxels_mesh->GetVoxels());
+		compute_mesher.Wait(computed_model->GetComputeValue());
+		auto &vertex_buffer = computed_model->GetVertexBuffer();
+		auto compute_quads = vertex_buffer != nullptr ? GetSortedQuads(ReadVertices(device, *vertex_buffer)) : std::vector<Quad>();
+
+		if (cpu_quads == compute_quads)
+		{
+			return true;
+		}
+
+		std::cerr << "Mismatch in corpus " << corpus.name << " at chunk (" << chunk_x << ", " << chunk_z << "): "
+				  << cpu_quads.size() << " CPU quads, " << compute_quads.size() << " compute quads" << std::endl;
+
+		auto mismatch = std::mismatch(cpu_quads.begin(), cpu_quads.end(), compute_quads.begin(), compute_quads.end());
+		if (mismatch.first != cpu_quads.end())
+		{
+			PrintQuad("first CPU quad missing from compute", *mismatch.first);
+		}
+		if (mismatch.second != compute_quads.end())
+		{
+			PrintQuad("first compute quad missing from CPU", *mismatch.second);
+		}
+		return false;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	try
+	{
+		std::string shader_path = PLAINCRAFT_SHADERS_DIRECTORY "/chunk_mesh_comp.spv";
+
+		for (int i = 1; i < argc; ++i)
+		{
+			if (std::strcmp(argv[i], "--shader") == 0 && i + 1 < argc)
+			{
+				shader_path = argv[++i];
+			}
+			else
+			{
+				throw std::runtime_error(std::string("Unknown argument ") + argv[i]);
+			}
+		}
+
+		VulkanInstanceConfig instance_config;
+		instance_config.enable_debug = false;
+		instance_config.headless = true;
+
+		std::unique_ptr<VulkanInstance> instance;
+		std::unique_ptr<VulkanDevice> device;
+		try
+		{
+			instance = std::make_unique<VulkanInstance>(instance_config);
+			device = std::make_unique<VulkanDevice>(*instance, VK_NULL_HANDLE);
+		}
+		catch (const std::exception &ex)
+		{
+			std::cerr << "Skipped, no Vulkan device to mesh on: " << ex.what() << std::endl;
+			return skipped_exit_code;
+		}
+
+		auto mismatches_count = 0;
+		{
+			VulkanQuadIndexBuffer quad_index_buffer(*device);
+			VulkanChunkComputeMesher compute_mesher(*device, quad_index_buffer, read_file_raw(shader_path));
+
+			// The compute shader emits one quad per visible face, the same as the naive mesher
+			ChunkMesher cpu_mesher(MeshingMode::Naive, MeshingBackend::Cpu);
+			ChunkMesher voxels_packer(MeshingMode::Naive, MeshingBackend::Compute);
+
+			for (auto &corpus : CreateCorpora())
+			{
+				for (int32_t chunk_z = 0; chunk_z < corpus_size; ++chunk_z)
+				{
+					for (int32_t chunk_x = 0; chunk_x < corpus_size; ++chunk_x)
+					{
+						if (!CompareChunk(corpus, chunk_x, chunk_z, cpu_mesher, voxels_packer, compute_mesher, *device))
+						{
+							++mismatches_count;
+						}
+					}
+				}
+			}
+		}
+
+		device.reset();
+		instance.reset();
+
+		if (mismatches_count > 0)
+		{
+			std::cerr << mismatches_count << " chunks meshed differently" << std::endl;
+			return 1;
+		}
+
+		std::cout << "Compute and CPU meshes match" << std::endl;
+	}
+	catch (const std::exception &ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}